@@ -0,0 +1,58 @@
+#include "ChessState.h"
+
+ChessState::ChessState(Game& game, const Position& root)
+    : game(game), position(root), plies(0), upToDate(false), result(GameResult::Ongoing) {}
+
+void ChessState::update() const {
+    if (upToDate) {
+        return;
+    }
+    game.GenerateMoves(position, legalMoves);
+    result = game.GetResult(position, legalMoves);
+    if (result == GameResult::Ongoing && plies >= MAX_PLAYOUT_PLIES) {
+        result = GameResult::Draw;
+    }
+    upToDate = true;
+}
+
+void ChessState::getMoves(MoveList& moves) const {
+    update();
+    moves = legalMoves;
+}
+
+void ChessState::play(Move move) {
+    game.MakeMove(position, move);
+    plies++;
+    upToDate = false;
+}
+
+void ChessState::undo(Move move) {
+    game.UnmakeMove(position, move);
+    plies--;
+    upToDate = false;
+}
+
+bool ChessState::isTerminal() const {
+    update();
+    return result != GameResult::Ongoing;
+}
+
+double ChessState::getReward() const {
+    update();
+    if (result == GameResult::Draw || result == GameResult::Ongoing) {
+        return 0.5;
+    }
+    // The side to move is the one that lost or won; the last move was made by the other side
+    bool whiteMovedLast = !game.IsWhiteMove(position);
+    return (result == GameResult::WhiteWins) == whiteMovedLast ? 1.0 : 0.0;
+}
+
+std::unique_ptr<State> ChessState::clone() const {
+    auto copy = std::make_unique<ChessState>(game, position);
+    copy->plies = plies;
+    return copy;
+}
+
+void ChessState::encode(NetworkInput& input, const MoveList& moves) const {
+    Network::encode(position, moves, input);
+}
@@ -0,0 +1,44 @@
+#ifndef CHESS_STATE_H
+#define CHESS_STATE_H
+
+#include "MCTS.h"
+#include "../../src/include/Game.h"
+#include "../../src/include/Position.h"
+
+// The real chess rules behind the MCTS State interface. Holds one mutable Position and plays
+// on it with make/unmake, so a search thread needs exactly one of these and nothing on the
+// search's hot path touches the heap.
+class ChessState : public State {
+public:
+    // Random playouts are cut off this many moves past the root and scored as a draw
+    static const int MAX_PLAYOUT_PLIES = 400;
+
+    ChessState(Game& game, const Position& root);
+
+    void getMoves(MoveList& moves) const override;
+    void play(Move move) override;
+    void undo(Move move) override;
+    bool isTerminal() const override;
+    double getReward() const override;
+    uint64_t key() const override { return position.key; }
+    // Game keeps no state of its own, so the copies can share it
+    std::unique_ptr<State> clone() const override;
+    void encode(NetworkInput& input, const MoveList& moves) const override;
+
+    const Position& getPosition() const { return position; }
+
+private:
+    // Legal moves and result of the current position, worked out once per position since
+    // isTerminal and getMoves both need the moves
+    void update() const;
+
+    Game& game;
+    Position position;
+    int plies;
+
+    mutable bool upToDate;
+    mutable MoveList legalMoves;
+    mutable GameResult result;
+};
+
+#endif
@@ -1,79 +1,436 @@
-#include "mcts.h"
+#include "MCTS.h"
 #include <algorithm>
+#include <thread>
 
-Node::Node(std::unique_ptr<State> state, Node* parent)
-    : state(std::move(state)), parent(parent), totalReward(0), visits(0) {}
+namespace {
+    // Nodes hold atomics and can't be assigned; this only runs between searches
+    void copyNode(Node& to, const Node& from) {
+        to.move = from.move;
+        to.childCount = from.childCount;
+        to.expandedCount.store(from.expandedCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.expansion.store(from.expansion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.parent = from.parent;
+        to.firstChild = from.firstChild;
+        to.visits.store(from.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.totalReward.store(from.totalReward.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.prior = from.prior;
+    }
+}
+
+void Node::reset(Move nodeMove, uint32_t nodeParent) {
+    move = nodeMove;
+    childCount = 0;
+    expandedCount.store(0, std::memory_order_relaxed);
+    expansion.store(NotGenerated, std::memory_order_relaxed);
+    parent = nodeParent;
+    firstChild = NO_NODE;
+    visits.store(0, std::memory_order_relaxed);
+    totalReward.store(0, std::memory_order_relaxed);
+    prior = 0;
+}
+
+NodePool::NodePool(size_t capacity)
+    : nodes(std::make_unique<Node[]>(capacity)), nodeCapacity(capacity), used(0) {}
 
-Node::~Node() {
-    for (auto& child : children) {
-        child.reset();
+uint32_t NodePool::allocate(uint32_t count) {
+    uint64_t first = used.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > nodeCapacity) {
+        return NO_NODE;
     }
+    return static_cast<uint32_t>(first);
 }
 
-void Node::expand() {
-    auto nextStates = state->getNextStates();
-    for (auto& nextState : nextStates) {
-        children.push_back(std::make_unique<Node>(std::move(nextState), this));
+MCTS::MCTS(double explorationParameter, size_t maxNodes, int threadCount)
+    : explorationParameter(explorationParameter), threads(std::max(1, threadCount)), network(nullptr),
+      batchSize(1), pool(maxNodes), root(NO_NODE), rootKey(0), reused(0), iterations(0), stopped(false) {}
+
+void MCTS::setNetwork(const Network* evaluator, int leavesPerBatch) {
+    network = evaluator;
+    batchSize = std::max(1, leavesPerBatch);
+    clearTree();
+}
+
+uint32_t MCTS::select(uint32_t node) const {
+    const Node& parent = pool[node];
+    double logVisits = std::log(std::max<uint32_t>(parent.visits.load(std::memory_order_relaxed), 1));
+    uint32_t best = parent.firstChild;
+    double bestScore = -1e300;
+    uint32_t end = parent.firstChild + parent.expandedCount.load(std::memory_order_relaxed);
+    for (uint32_t i = parent.firstChild; i < end; ++i) {
+        const Node& child = pool[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        double score = child.totalReward.load(std::memory_order_relaxed) / visits +
+            explorationParameter * std::sqrt(logVisits / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
     }
+    return best;
 }
 
-Node* Node::select() {
-    if (!isFullyExpanded()) {
-        return this;
+// Unvisited children are valued at what the parent is worth to their mover, so a move the search
+// hasn't tried yet is judged by its prior alone
+uint32_t MCTS::selectWithPriors(uint32_t node) const {
+    const Node& parent = pool[node];
+    uint32_t parentVisits = parent.visits.load(std::memory_order_relaxed);
+    double sqrtVisits = std::sqrt(static_cast<double>(parentVisits));
+    double unvisitedValue = parentVisits > 0 ? 1.0 - parent.totalReward.load(std::memory_order_relaxed) / parentVisits : 0.5;
+    uint32_t best = parent.firstChild;
+    double bestScore = -1e300;
+    for (uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; ++i) {
+        const Node& child = pool[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        double value = visits > 0 ? child.totalReward.load(std::memory_order_relaxed) / visits : unvisitedValue;
+        double score = value + explorationParameter * child.prior * sqrtVisits / (1 + visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
     }
-    return std::max_element(children.begin(), children.end(),
-        [](const std::unique_ptr<Node>& a, const std::unique_ptr<Node>& b) {
-            return a->totalReward / a->visits < b->totalReward / b->visits;
-        })->get();
+    return best;
 }
 
-void Node::backpropagate(double reward) {
-    visits++;
-    totalReward += reward;
-    if (parent) {
-        parent->backpropagate(reward);
+bool MCTS::generateChildren(uint32_t node, Worker& worker) {
+    worker.state->getMoves(worker.moves);
+    uint32_t first = pool.allocate(static_cast<uint32_t>(worker.moves.size()));
+    if (first == NO_NODE) {
+        return false;
     }
+    // Shuffled once here, so taking the untried moves in order expands them in random order
+    std::shuffle(worker.moves.begin(), worker.moves.end(), worker.rng);
+    for (int m = 0; m < worker.moves.size(); ++m) {
+        pool[first + m].reset(worker.moves[m], node);
+    }
+    pool[node].firstChild = first;
+    pool[node].childCount = static_cast<uint16_t>(worker.moves.size());
+    return true;
 }
 
-bool Node::isFullyExpanded() const {
-    return !children.empty() && children.size() == state->getNextStates().size();
+// The visit is counted on the way down; the reward follows in backpropagate
+void MCTS::enter(Worker& worker, uint32_t node) {
+    pool[node].visits.fetch_add(1, std::memory_order_relaxed);
+    worker.state->play(pool[node].move);
+    worker.path.push_back(pool[node].move);
 }
 
-bool Node::isLeaf() const {
-    return children.empty();
+uint32_t MCTS::descend(Worker& worker) {
+    uint32_t node = root;
+    pool[root].visits.fetch_add(1, std::memory_order_relaxed);
+
+    while (!worker.state->isTerminal()) {
+        Node& current = pool[node];
+
+        uint8_t expansion = current.expansion.load(std::memory_order_acquire);
+        if (expansion == Node::NotGenerated) {
+            if (!current.expansion.compare_exchange_strong(expansion, Node::Generating, std::memory_order_acquire)) {
+                return node;
+            }
+            if (!generateChildren(node, worker)) {
+                current.expansion.store(Node::NotGenerated, std::memory_order_release);
+                stopped = true;
+                return node;
+            }
+            current.expansion.store(Node::Generated, std::memory_order_release);
+        }
+        else if (expansion == Node::Generating) {
+            // Someone else is generating the children; play out from here instead of waiting
+            return node;
+        }
+
+        // Open the next untried move if there is one, otherwise carry on down the best child
+        uint16_t expanded = current.expandedCount.load(std::memory_order_relaxed);
+        while (expanded < current.childCount) {
+            if (current.expandedCount.compare_exchange_weak(expanded, expanded + 1, std::memory_order_relaxed)) {
+                uint32_t child = current.firstChild + expanded;
+                enter(worker, child);
+                return child;
+            }
+        }
+        node = select(node);
+        enter(worker, node);
+    }
+    return node;
 }
 
-MCTS::MCTS(int iterations, double explorationParameter)
-    : iterations(iterations), explorationParameter(explorationParameter), rng(std::random_device{}()) {}
+MCTS::Leaf MCTS::descendWithNetwork(Worker& worker, uint32_t& node) {
+    node = root;
+    pool[root].visits.fetch_add(1, std::memory_order_relaxed);
 
-Node* MCTS::search(std::unique_ptr<State> initialState) {
-    auto root = std::make_unique<Node>(std::move(initialState));
+    while (!worker.state->isTerminal()) {
+        Node& current = pool[node];
 
-    for (int i = 0; i < iterations; ++i) {
-        Node* node = root.get();
+        uint8_t expansion = current.expansion.load(std::memory_order_acquire);
+        if (expansion == Node::Generated) {
+            node = selectWithPriors(node);
+            enter(worker, node);
+            continue;
+        }
+        // Waiting on a batch, ours or another thread's
+        if (expansion == Node::Generating ||
+            !current.expansion.compare_exchange_strong(expansion, Node::Generating, std::memory_order_acquire)) {
+            return Leaf::Collision;
+        }
+        if (!generateChildren(node, worker)) {
+            current.expansion.store(Node::NotGenerated, std::memory_order_release);
+            stopped = true;
+            return Leaf::Collision;
+        }
+        // worker.moves is in the children's order now
+        worker.state->encode(worker.batch.add(), worker.moves);
+        worker.leaves.push_back(node);
+        return Leaf::Queued;
+    }
+    return Leaf::Terminal;
+}
+
+void MCTS::flush(Worker& worker) {
+    if (worker.batch.count == 0) {
+        return;
+    }
+    network->evaluate(worker.batch);
 
-        // Selection
-        while (!node->isLeaf() && node->isFullyExpanded()) {
-            node = node->select();
+    for (int i = 0; i < worker.batch.count; ++i) {
+        Node& leaf = pool[worker.leaves[i]];
+        const float* priors = &worker.batch.priors[static_cast<size_t>(i) * MAX_MOVES];
+        for (uint32_t c = 0; c < leaf.childCount; ++c) {
+            pool[leaf.firstChild + c].prior = priors[c];
         }
+        leaf.expandedCount.store(leaf.childCount, std::memory_order_relaxed);
+        leaf.expansion.store(Node::Generated, std::memory_order_release);
+
+        // The value is for the side to move at the leaf, the reward for the one who moved into it
+        backpropagate(worker.leaves[i], 1.0 - worker.batch.values[i]);
+    }
+    worker.batch.count = 0;
+    worker.leaves.clear();
+}
+
+void MCTS::revert(uint32_t node) {
+    for (; node != NO_NODE; node = pool[node].parent) {
+        pool[node].visits.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
 
-        // Expansion
-        if (!node->isFullyExpanded()) {
-            node->expand();
-            node = node->children.back().get();
+void MCTS::backpropagate(uint32_t node, double reward) {
+    for (; node != NO_NODE; node = pool[node].parent) {
+        std::atomic<float>& total = pool[node].totalReward;
+        float current = total.load(std::memory_order_relaxed);
+        while (!total.compare_exchange_weak(current, current + static_cast<float>(reward), std::memory_order_relaxed)) {
         }
+        reward = 1.0 - reward;
+    }
+}
+
+void MCTS::rewind(Worker& worker) {
+    for (size_t m = worker.path.size(); m-- > 0;) {
+        worker.state->undo(worker.path[m]);
+    }
+    worker.path.clear();
+}
+
+bool MCTS::shouldStop(const MctsLimits& limits) const {
+    if (stopped.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (limits.nodes > 0 && pool.size() >= limits.nodes) {
+        return true;
+    }
+    if (limits.moveTime >= 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return elapsed.count() >= limits.moveTime;
+    }
+    return false;
+}
+
+// The iteration is claimed before it runs, so the count never overshoots the limit
+bool MCTS::claimIteration(const MctsLimits& limits) {
+    uint64_t iteration = iterations.fetch_add(1, std::memory_order_relaxed);
+    if (limits.iterations > 0 && iteration >= limits.iterations) {
+        iterations.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void MCTS::work(Worker& worker, const MctsLimits& limits) {
+    while (!shouldStop(limits) && claimIteration(limits)) {
+        uint32_t node = descend(worker);
+        size_t nodeDepth = worker.path.size();
 
         // Simulation
-        auto currentState = node->state->getNextStates()[0]->clone();
-        while (!currentState->isTerminal()) {
-            auto nextStates = currentState->getNextStates();
-            std::uniform_int_distribution<> dist(0, nextStates.size() - 1);
-            currentState = nextStates[dist(rng)]->clone();
+        while (!worker.state->isTerminal()) {
+            worker.state->getMoves(worker.moves);
+            std::uniform_int_distribution<int> dist(0, worker.moves.size() - 1);
+            Move move = worker.moves[dist(worker.rng)];
+            worker.state->play(move);
+            worker.path.push_back(move);
+        }
+
+        // Backpropagation. The reward is for whoever moved last; with an odd number of playout
+        // moves that was the other player from the one who moved into node.
+        double reward = worker.state->getReward();
+        backpropagate(node, (worker.path.size() - nodeDepth) % 2 == 0 ? reward : 1.0 - reward);
+        rewind(worker);
+    }
+}
+
+void MCTS::workWithNetwork(Worker& worker, const MctsLimits& limits) {
+    bool stopping = false;
+    while (!stopping) {
+        while (!worker.batch.full()) {
+            if (shouldStop(limits) || !claimIteration(limits)) {
+                stopping = true;
+                break;
+            }
+            uint32_t node;
+            Leaf leaf = descendWithNetwork(worker, node);
+            if (leaf == Leaf::Terminal) {
+                backpropagate(node, worker.state->getReward());
+            }
+            else if (leaf == Leaf::Collision) {
+                revert(node);
+                iterations.fetch_sub(1, std::memory_order_relaxed);
+            }
+            rewind(worker);
+            // Rather than keep running into the pending leaf, evaluate what we have. With nothing
+            // queued the leaf is in another thread's batch, so give that thread the core.
+            if (leaf == Leaf::Collision) {
+                if (worker.batch.count == 0) {
+                    std::this_thread::yield();
+                }
+                break;
+            }
+        }
+        // Every leaf this thread queued is evaluated before it returns, so no node is left Generating
+        flush(worker);
+    }
+}
+
+void MCTS::compact(uint32_t newRoot) {
+    // Every child block is allocated after its parent, so moving the kept blocks down in pool
+    // order only ever overwrites nodes that were discarded or have already been moved
+    std::vector<uint32_t> blocks;
+    std::vector<uint32_t> pending{ newRoot };
+    while (!pending.empty()) {
+        const Node& node = pool[pending.back()];
+        pending.pop_back();
+        if (node.firstChild == NO_NODE) {
+            continue;
+        }
+        blocks.push_back(node.firstChild);
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+            pending.push_back(child);
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    // Moves a node to its new index and points its children, still in their old places, at it
+    auto relocate = [this](uint32_t to, uint32_t from) {
+        if (to != from) {
+            copyNode(pool[to], pool[from]);
+        }
+        const Node& node = pool[to];
+        if (node.firstChild != NO_NODE) {
+            for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+                pool[child].parent = to;
+            }
+        }
+    };
+
+    relocate(0, newRoot);
+    pool[0].move = Move::none();
+    pool[0].parent = NO_NODE;
+    uint32_t next = 1;
+    for (uint32_t block : blocks) {
+        Node& parent = pool[pool[block].parent];
+        uint32_t count = parent.childCount;
+        parent.firstChild = next;
+        for (uint32_t i = 0; i < count; ++i) {
+            relocate(next + i, block + i);
+        }
+        next += count;
+    }
+    pool.truncate(next);
+    root = 0;
+}
+
+void MCTS::advance(Move move, const State& state) {
+    if (root == NO_NODE) {
+        return;
+    }
+    const Node& current = pool[root];
+    if (current.firstChild != NO_NODE) {
+        for (uint32_t child = current.firstChild; child < current.firstChild + current.childCount; ++child) {
+            if (pool[child].move == move) {
+                compact(child);
+                rootKey = state.key();
+                return;
+            }
+        }
+    }
+    clearTree();
+}
+
+Move MCTS::search(State& state, const MctsLimits& limits) {
+    if (root == NO_NODE || rootKey != state.key()) {
+        pool.reset();
+        root = pool.allocate(1);
+        pool[root].reset(Move::none(), NO_NODE);
+        rootKey = state.key();
+    }
+    reused = pool[root].visits;
+    iterations = 0;
+    stopped = false;
+    start = std::chrono::steady_clock::now();
+
+    // Thread 0 is the caller and plays on the state it was given
+    std::random_device seed;
+    std::vector<std::unique_ptr<State>> copies;
+    std::vector<Worker> workers(threads);
+    for (int i = 0; i < threads; ++i) {
+        if (i > 0) {
+            copies.push_back(state.clone());
+        }
+        workers[i].state = i == 0 ? &state : copies.back().get();
+        workers[i].rng.seed(seed());
+        workers[i].path.reserve(1024);
+        if (network) {
+            workers[i].batch = NetworkBatch(batchSize);
+            workers[i].leaves.reserve(batchSize);
         }
+    }
 
-        // Backpropagation
-        node->backpropagate(currentState->getReward());
+    auto run = [this, &workers, &limits](int i) {
+        if (network) {
+            workWithNetwork(workers[i], limits);
+        }
+        else {
+            work(workers[i], limits);
+        }
+    };
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; ++i) {
+        helpers.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& helper : helpers) {
+        helper.join();
     }
 
-    return root->select();
-}
\ No newline at end of file
+    // The most visited move is the one the search trusts most
+    const Node& rootNode = pool[root];
+    Move best = Move::none();
+    uint32_t bestVisits = 0;
+    uint32_t end = rootNode.firstChild + rootNode.expandedCount.load();
+    for (uint32_t i = rootNode.firstChild; i < end; ++i) {
+        if (pool[i].visits >= bestVisits) {
+            bestVisits = pool[i].visits;
+            best = pool[i].move;
+        }
+    }
+    return best;
+}
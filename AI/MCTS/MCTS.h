@@ -1,47 +1,189 @@
 #ifndef MCTS_H
 #define MCTS_H
 
+#include "../../src/include/CommonComponents.h"
+#include "Network.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <cmath>
 #include <random>
 
+// A game position the search plays moves on in place. Each iteration walks it down the tree and
+// through a playout, then undoes every move to get back to the root, so nothing is copied.
 class State {
 public:
     virtual ~State() = default;
-    virtual std::vector<std::unique_ptr<State>> getNextStates() const = 0;
+    // Replaces the contents of moves with the legal moves
+    virtual void getMoves(MoveList& moves) const = 0;
+    virtual void play(Move move) = 0;
+    // Takes back the last move played
+    virtual void undo(Move move) = 0;
     virtual bool isTerminal() const = 0;
+    // Result of a terminal state for the player who made the last move: 1 win, 0.5 draw, 0 loss
     virtual double getReward() const = 0;
+    // Identifies the position, so a search can tell whether a kept tree belongs to it
+    virtual uint64_t key() const = 0;
+    // A private copy for another search thread. Called once per thread per search.
     virtual std::unique_ptr<State> clone() const = 0;
+    // Network inputs for the current position and the given legal moves. Only called when the
+    // search has a network.
+    virtual void encode(NetworkInput& input, const MoveList& moves) const = 0;
 };
 
-class Node {
+const uint32_t NO_NODE = UINT32_MAX;
+
+// One tree node. Nodes hold the move that reaches them rather than a copy of the state, and a
+// node's children sit next to each other in the pool, so the whole node is 28 bytes.
+//
+// The first visit generates the legal moves once and stores them straight into a block of child
+// nodes, in random order. After that the node is expanded one child at a time, taking the
+// children in block order; expandedCount says how many of them the search has opened.
+//
+// Several threads share the tree. Statistics are atomics, a thread claims the right to
+// generate a node's children by moving it from NotGenerated to Generating, and each untried
+// child is claimed by bumping expandedCount.
+//
+// With a network the children are all opened at once instead: the node stays Generating until
+// its batch has been evaluated, then gets its children's priors and becomes Generated.
+struct Node {
+    enum Expansion : uint8_t { NotGenerated, Generating, Generated };
+
+    Move move = Move::none();       // Move from the parent; none at the root
+    uint16_t childCount = 0;
+    std::atomic<uint16_t> expandedCount{ 0 };
+    std::atomic<uint8_t> expansion{ NotGenerated };
+    uint32_t parent = NO_NODE;
+    uint32_t firstChild = NO_NODE;  // Children are childCount consecutive nodes starting here
+    std::atomic<uint32_t> visits{ 0 };
+    std::atomic<float> totalReward{ 0 };
+    float prior = 0;                // Policy network's probability for move; unused without one
+
+    void reset(Move move, uint32_t parent);
+};
+
+// Index-addressed arena for the tree. Nodes are never freed one by one; reset() drops the
+// whole tree at once and truncate() drops everything past a compacted prefix. allocate() may be
+// called from several threads.
+class NodePool {
 public:
-    Node(std::unique_ptr<State> state, Node* parent = nullptr);
-    ~Node();
-
-    void expand();
-    Node* select();
-    void backpropagate(double reward);
-    bool isFullyExpanded() const;
-    bool isLeaf() const;
-
-    std::unique_ptr<State> state;
-    Node* parent;
-    std::vector<std::unique_ptr<Node>> children;
-    double totalReward;
-    int visits;
+    explicit NodePool(size_t capacity);
+
+    // First of count consecutive new nodes, or NO_NODE when the pool is full
+    uint32_t allocate(uint32_t count);
+    void reset() { used = 0; }
+    // Keeps the first count nodes and frees the rest
+    void truncate(size_t count) { used = count; }
+
+    Node& operator[](uint32_t index) { return nodes[index]; }
+    const Node& operator[](uint32_t index) const { return nodes[index]; }
+    size_t size() const { return std::min<size_t>(used.load(std::memory_order_relaxed), nodeCapacity); }
+    size_t capacity() const { return nodeCapacity; }
+
+private:
+    std::unique_ptr<Node[]> nodes;
+    size_t nodeCapacity;
+    std::atomic<uint64_t> used;
+};
+
+// When to stop. Whichever limit is hit first ends the search; zero or -1 means no limit.
+struct MctsLimits {
+    uint64_t iterations = 0;
+    int64_t moveTime = -1;          // Milliseconds
+    size_t nodes = 0;               // Tree nodes, on top of the pool's own capacity
 };
 
+// Tree-parallel MCTS: every thread descends the same tree. A thread counts a visit on each node
+// as it passes and only adds the reward on the way back, so until then the path looks like a
+// loss to the others (virtual loss) and they spread out over different lines.
+//
+// Without a network, leaves are scored by random playouts and children chosen by UCT. With one,
+// each thread queues the leaves of several descents in a row, held apart by the virtual loss,
+// evaluates them as one batch, and chooses children by PUCT: the mean reward plus an exploration
+// term weighted by the network's prior for the move.
 class MCTS {
 public:
-    MCTS(int iterations, double explorationParameter = std::sqrt(2));
-    Node* search(std::unique_ptr<State> initialState);
+    MCTS(double explorationParameter = std::sqrt(2), size_t maxNodes = 1 << 20, int threadCount = 1);
+
+    // Only between searches
+    void setThreadCount(int threadCount) { threads = std::max(1, threadCount); }
+    // Evaluates leaves with network, batchSize at a time per thread, or with random playouts
+    // when it is null. Only between searches; the tree is cleared.
+    void setNetwork(const Network* network, int batchSize = 16);
+
+    // Leaves the state as it was passed in. The kept tree is searched on only if its root is
+    // the same position as state, which is the case after advance() with every move played;
+    // otherwise the search starts from an empty tree.
+    Move search(State& state, const MctsLimits& limits);
+    // Makes the child reached by move the new root, keeping its subtree and statistics and
+    // freeing the rest. Call it for every move played on the board, ours and the opponent's,
+    // between searches, with the state as it is after the move. A move the tree never
+    // generated leaves it empty.
+    void advance(Move move, const State& state);
+    // The next search starts from an empty tree
+    void clearTree() { root = NO_NODE; }
+    // Visits the root already had when the last search started, carried over by advance()
+    uint32_t reusedVisits() const { return reused; }
+    // Nodes in the tree and playouts run by the last search
+    size_t nodeCount() const { return pool.size(); }
+    uint64_t iterationCount() const { return iterations.load(std::memory_order_relaxed); }
 
 private:
-    int iterations;
+    // Each thread's own state copy and scratch space
+    struct Worker {
+        State* state;
+        std::mt19937 rng;
+        MoveList moves;
+        std::vector<Move> path;     // Moves played from the root this iteration, to undo afterwards
+        NetworkBatch batch;
+        std::vector<uint32_t> leaves;  // Node waiting on each entry of batch
+    };
+
+    // Where a descent with a network ended
+    enum class Leaf { Terminal, Queued, Collision };
+
+    void work(Worker& worker, const MctsLimits& limits);
+    void workWithNetwork(Worker& worker, const MctsLimits& limits);
+    // Counts one more iteration; false once the iteration limit has been reached
+    bool claimIteration(const MctsLimits& limits);
+    // Selection and expansion; returns the node the playout starts from
+    uint32_t descend(Worker& worker);
+    // The expanded child of node with the best UCT score
+    uint32_t select(uint32_t node) const;
+    // Descent by PUCT. Queues a new leaf in the worker's batch, or stops at a terminal node or
+    // at one whose evaluation is still pending; node is where it ended.
+    Leaf descendWithNetwork(Worker& worker, uint32_t& node);
+    // The child of node with the best PUCT score
+    uint32_t selectWithPriors(uint32_t node) const;
+    // Evaluates the worker's batch, stores the priors and backs up the values
+    void flush(Worker& worker);
+    // Takes back the visits a descent counted on its way down to node
+    void revert(uint32_t node);
+    // Stores the state's legal moves as node's children. False when the pool is full.
+    bool generateChildren(uint32_t node, Worker& worker);
+    void enter(Worker& worker, uint32_t node);
+    // reward is for the player who moved into node; it flips at every level on the way up
+    void backpropagate(uint32_t node, double reward);
+    // Undoes the moves of this iteration, back to the root
+    void rewind(Worker& worker);
+    bool shouldStop(const MctsLimits& limits) const;
+    // Moves the subtree under newRoot to the front of the pool and frees everything else
+    void compact(uint32_t newRoot);
+
     double explorationParameter;
-    std::mt19937 rng;
+    int threads;
+    const Network* network;
+    int batchSize;
+    NodePool pool;
+    uint32_t root;
+    uint64_t rootKey;
+    uint32_t reused;
+    std::atomic<uint64_t> iterations;
+    std::atomic<bool> stopped;
+    std::chrono::steady_clock::time_point start;
 };
 
-#endif 
\ No newline at end of file
+#endif
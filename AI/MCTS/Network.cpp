@@ -0,0 +1,269 @@
+#include "Network.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    const char MAGIC[4] = { 'P', 'C', 'N', 'N' };
+    const uint32_t VERSION = 2;
+
+    // Activations are 1.0 = 127 and int8 weights 1.0 = 64
+    const int WEIGHT_SHIFT = 6;
+    const float OUTPUT_SCALE = 127.0f * 64.0f;
+
+    // Sum of a[i] * b[i] over size elements. a is an activation, so at most 127, which keeps
+    // the pairwise int16 sums of maddubs from saturating.
+    int32_t Dot(const uint8_t* a, const int8_t* b, int size) {
+        int32_t sum = 0;
+        int i = 0;
+#if defined(__AVX512BW__)
+        __m512i acc512 = _mm512_setzero_si512();
+        for (; i + 64 <= size; i += 64) {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+#if defined(__AVX512VNNI__)
+            acc512 = _mm512_dpbusd_epi32(acc512, x, y);
+#else
+            __m512i pairs = _mm512_maddubs_epi16(x, y);
+            acc512 = _mm512_add_epi32(acc512, _mm512_madd_epi16(pairs, _mm512_set1_epi16(1)));
+#endif
+        }
+        sum += _mm512_reduce_add_epi32(acc512);
+#endif
+#if defined(__AVX2__)
+        __m256i acc256 = _mm256_setzero_si256();
+        for (; i + 32 <= size; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i pairs = _mm256_maddubs_epi16(x, y);
+            acc256 = _mm256_add_epi32(acc256, _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+        }
+        __m128i lanes = _mm_add_epi32(_mm256_castsi256_si128(acc256), _mm256_extracti128_si256(acc256, 1));
+        lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, _MM_SHUFFLE(1, 0, 3, 2)));
+        lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum += _mm_cvtsi128_si32(lanes);
+#endif
+        for (; i < size; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    // acc[i] += row[i], wrapping like the vector instructions do
+    void AddRow(int16_t* acc, const int16_t* row, int size) {
+        int i = 0;
+#if defined(__AVX512BW__)
+        for (; i + 32 <= size; i += 32) {
+            __m512i sum = _mm512_add_epi16(_mm512_loadu_si512(acc + i), _mm512_loadu_si512(row + i));
+            _mm512_storeu_si512(acc + i, sum);
+        }
+#endif
+#if defined(__AVX2__)
+        for (; i + 16 <= size; i += 16) {
+            __m256i sum = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), sum);
+        }
+#endif
+        for (; i < size; ++i) {
+            acc[i] = static_cast<int16_t>(acc[i] + row[i]);
+        }
+    }
+
+    // out[r * outputs + o] = biases[o] + row r of input . row o of weights, for every row of the
+    // batch. Outputs are the outer loop so a weight row is reused across the batch while it is
+    // still in cache.
+    void Gemm(const uint8_t* input, int rows, int size, const int8_t* weights, const int32_t* biases,
+              int outputs, int32_t* out) {
+        for (int o = 0; o < outputs; ++o) {
+            const int8_t* weightRow = weights + static_cast<size_t>(o) * size;
+            for (int r = 0; r < rows; ++r) {
+                out[static_cast<size_t>(r) * outputs + o] = biases[o] + Dot(input + static_cast<size_t>(r) * size, weightRow, size);
+            }
+        }
+    }
+
+    uint8_t ClippedRelu(int value) {
+        return static_cast<uint8_t>(std::clamp(value, 0, 127));
+    }
+
+    template <typename T>
+    void WriteArray(std::ofstream& file, const std::vector<T>& values) {
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void ReadArray(std::ifstream& file, std::vector<T>& values, size_t count) {
+        values.resize(count);
+        file.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+    }
+}
+
+NetworkBatch::NetworkBatch(int capacity)
+    : inputs(capacity), values(capacity), priors(static_cast<size_t>(capacity) * MAX_MOVES),
+      hidden(static_cast<size_t>(capacity) * Network::HIDDEN), sums(static_cast<size_t>(capacity) * Network::HIDDEN2),
+      hidden2(static_cast<size_t>(capacity) * Network::HIDDEN2) {}
+
+const char* Network::kernelName() {
+#if defined(__AVX512VNNI__)
+    return "AVX-512 VNNI";
+#elif defined(__AVX512BW__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+// The file is a header of magic, version and layer sizes as uint32, then every weight array in
+// declaration order, all in the machine's byte order (little-endian everywhere we build)
+bool Network::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[4];
+    uint32_t header[5];
+    if (!file.read(magic, sizeof(magic)) || !file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+    if (!std::equal(magic, magic + 4, MAGIC) || header[0] != VERSION || header[1] != INPUTS ||
+        header[2] != HIDDEN || header[3] != HIDDEN2 || header[4] != POLICY_OUTPUTS) {
+        return false;
+    }
+
+    Network network;
+    ReadArray(file, network.inputWeights, static_cast<size_t>(INPUTS) * HIDDEN);
+    ReadArray(file, network.inputBiases, HIDDEN);
+    ReadArray(file, network.hiddenWeights, static_cast<size_t>(HIDDEN2) * HIDDEN);
+    ReadArray(file, network.hiddenBiases, HIDDEN2);
+    ReadArray(file, network.valueWeights, HIDDEN2);
+    file.read(reinterpret_cast<char*>(&network.valueBias), sizeof(network.valueBias));
+    ReadArray(file, network.policyWeights, static_cast<size_t>(POLICY_OUTPUTS) * HIDDEN2);
+    ReadArray(file, network.policyBiases, POLICY_OUTPUTS);
+    if (!file) {
+        return false;
+    }
+    *this = std::move(network);
+    return true;
+}
+
+bool Network::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    uint32_t header[5] = { VERSION, INPUTS, HIDDEN, HIDDEN2, POLICY_OUTPUTS };
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    WriteArray(file, inputWeights);
+    WriteArray(file, inputBiases);
+    WriteArray(file, hiddenWeights);
+    WriteArray(file, hiddenBiases);
+    WriteArray(file, valueWeights);
+    file.write(reinterpret_cast<const char*>(&valueBias), sizeof(valueBias));
+    WriteArray(file, policyWeights);
+    WriteArray(file, policyBiases);
+    return static_cast<bool>(file);
+}
+
+void Network::randomize(uint32_t seed) {
+    std::mt19937 rng(seed);
+    auto fill = [&rng](auto& values, size_t count, int low, int high) {
+        std::uniform_int_distribution<int> dist(low, high);
+        values.resize(count);
+        for (auto& value : values) {
+            value = static_cast<typename std::decay_t<decltype(values)>::value_type>(dist(rng));
+        }
+    };
+    fill(inputWeights, static_cast<size_t>(INPUTS) * HIDDEN, -12, 12);
+    fill(inputBiases, HIDDEN, 0, 32);
+    fill(hiddenWeights, static_cast<size_t>(HIDDEN2) * HIDDEN, -8, 8);
+    fill(hiddenBiases, HIDDEN2, 0, 0);
+    fill(valueWeights, HIDDEN2, -8, 8);
+    valueBias = 0;
+    fill(policyWeights, static_cast<size_t>(POLICY_OUTPUTS) * HIDDEN2, -16, 16);
+    fill(policyBiases, POLICY_OUTPUTS, 0, 0);
+}
+
+// Squares are mirrored top to bottom when black is to move, and the inputs list the side to
+// move's pieces first, so both sides look the same to the network
+void Network::encode(const Position& position, const MoveList& moves, NetworkInput& input) {
+    bool white = position.moveCount % 2 != 0;
+    int flip = white ? 0 : 56;
+
+    input.featureCount = 0;
+    for (int square = 0; square < TOTAL_SQUARES; ++square) {
+        int piece = position.board[square];
+        if (piece == Piece::None) {
+            continue;
+        }
+        bool own = ((piece & Piece::White) != 0) == white;
+        int type = (piece & 7) - 1;
+        input.features[input.featureCount++] = static_cast<uint16_t>(((own ? 0 : 6) + type) * 64 + (square ^ flip));
+    }
+
+    input.moveCount = moves.size();
+    for (int m = 0; m < moves.size(); ++m) {
+        Move move = moves[m];
+        int from = move.startSquare() ^ flip;
+        int to = move.targetSquare() ^ flip;
+        int output = from * 64 + to;
+        if (move.isPromotion() && move.promotionType() != Piece::Queen) {
+            int direction = (to & 7) - (from & 7) + 1;
+            output = 64 * 64 + ((move.promotionType() - Piece::Knight) * 8 + (from & 7)) * 3 + direction;
+        }
+        input.policyIndices[m] = static_cast<uint16_t>(output);
+    }
+}
+
+void Network::evaluate(NetworkBatch& batch) const {
+    int count = batch.count;
+
+    // Input layer: only the rows of the active inputs are summed
+    std::array<int16_t, HIDDEN> acc;
+    for (int r = 0; r < count; ++r) {
+        const NetworkInput& input = batch.inputs[r];
+        std::copy(inputBiases.begin(), inputBiases.end(), acc.begin());
+        for (int f = 0; f < input.featureCount; ++f) {
+            AddRow(acc.data(), &inputWeights[static_cast<size_t>(input.features[f]) * HIDDEN], HIDDEN);
+        }
+        uint8_t* hidden = &batch.hidden[static_cast<size_t>(r) * HIDDEN];
+        for (int i = 0; i < HIDDEN; ++i) {
+            hidden[i] = ClippedRelu(acc[i]);
+        }
+    }
+
+    Gemm(batch.hidden.data(), count, HIDDEN, hiddenWeights.data(), hiddenBiases.data(), HIDDEN2, batch.sums.data());
+    for (size_t i = 0; i < static_cast<size_t>(count) * HIDDEN2; ++i) {
+        batch.hidden2[i] = ClippedRelu(batch.sums[i] >> WEIGHT_SHIFT);
+    }
+
+    Gemm(batch.hidden2.data(), count, HIDDEN2, valueWeights.data(), &valueBias, 1, batch.sums.data());
+    for (int r = 0; r < count; ++r) {
+        batch.values[r] = 1.0f / (1.0f + std::exp(-batch.sums[r] / OUTPUT_SCALE));
+    }
+
+    // Policy head: only the outputs of the legal moves are worked out, then softmaxed
+    for (int r = 0; r < count; ++r) {
+        const NetworkInput& input = batch.inputs[r];
+        const uint8_t* hidden2 = &batch.hidden2[static_cast<size_t>(r) * HIDDEN2];
+        float* priors = &batch.priors[static_cast<size_t>(r) * MAX_MOVES];
+        float highest = -1e30f;
+        for (int m = 0; m < input.moveCount; ++m) {
+            int output = input.policyIndices[m];
+            int32_t logit = policyBiases[output] + Dot(hidden2, &policyWeights[static_cast<size_t>(output) * HIDDEN2], HIDDEN2);
+            priors[m] = logit / OUTPUT_SCALE;
+            highest = std::max(highest, priors[m]);
+        }
+        float total = 0;
+        for (int m = 0; m < input.moveCount; ++m) {
+            priors[m] = std::exp(priors[m] - highest);
+            total += priors[m];
+        }
+        for (int m = 0; m < input.moveCount; ++m) {
+            priors[m] /= total;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include "../../src/include/CommonComponents.h"
+#include "../../src/include/Position.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What the network needs from one leaf: the active inputs and, for each legal move in the order
+// the search stores the children, which policy output scores it. Both are seen from the side to
+// move, so the network never has to know whose turn it is.
+struct NetworkInput {
+    uint16_t features[32];          // One per piece; LoadFEN turns down positions with more
+    int featureCount = 0;
+    uint16_t policyIndices[MAX_MOVES];
+    int moveCount = 0;
+};
+
+// A search thread's leaves waiting for the network, with the scratch space to evaluate them.
+// values[i] is the chance that the side to move in inputs[i] wins; priors[i * MAX_MOVES + m] is
+// the softmax probability of its move m.
+struct NetworkBatch {
+    std::vector<NetworkInput> inputs;
+    int count = 0;
+    std::vector<float> values;
+    std::vector<float> priors;
+
+    std::vector<uint8_t> hidden;
+    std::vector<int32_t> sums;
+    std::vector<uint8_t> hidden2;
+
+    explicit NetworkBatch(int capacity = 0);
+    int capacity() const { return static_cast<int>(inputs.size()); }
+    bool full() const { return count == capacity(); }
+    NetworkInput& add() { return inputs[count++]; }
+};
+
+// Policy and value network for MCTS, run on the CPU with integer arithmetic.
+//
+// 768 one-hot piece-square inputs feed a 256-wide int16 layer that is summed from the active
+// inputs only. Its clipped output, as uint8, goes through a 32-wide int8 layer and then to two
+// int8 heads: one value and 4168 policy logits. The first 4096 are one per from-to square pair,
+// which covers queen promotions too; the last 72 are the knight, bishop and rook promotions, by
+// piece, starting file and whether the pawn captures left, pushes or captures right. Activations are
+// fixed point with 1.0 = 127 and int8 weights with 1.0 = 64, so an int8 dot product needs
+// shifting down by 6.
+//
+// The dense layers run as one matrix product over the whole batch, so each weight row is loaded
+// once per batch rather than once per position. The kernels use AVX-512 or AVX2 when the build
+// targets them (/arch:AVX2 or -mavx2, and so on) and plain loops otherwise.
+class Network {
+public:
+    static const int INPUTS = 768;
+    static const int HIDDEN = 256;
+    static const int HIDDEN2 = 32;
+    static const int UNDERPROMOTION_OUTPUTS = 3 * 8 * 3;
+    static const int POLICY_OUTPUTS = 64 * 64 + UNDERPROMOTION_OUTPUTS;
+
+    // Reads weights written by save(). False, leaving the network as it was, if the file is
+    // missing or was made for different layer sizes.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    // Small random weights, for trying out the search and the file format without a trained net
+    void randomize(uint32_t seed);
+    bool loaded() const { return !inputWeights.empty(); }
+
+    // Fills input for the position and its legal moves, in the order given
+    static void encode(const Position& position, const MoveList& moves, NetworkInput& input);
+    // Evaluates batch.inputs[0, batch.count) into batch.values and batch.priors
+    void evaluate(NetworkBatch& batch) const;
+
+    // Which kernels this build uses
+    static const char* kernelName();
+
+private:
+    std::vector<int16_t> inputWeights;     // INPUTS x HIDDEN, one row per input
+    std::vector<int16_t> inputBiases;      // HIDDEN
+    std::vector<int8_t> hiddenWeights;     // HIDDEN2 x HIDDEN, one row per output
+    std::vector<int32_t> hiddenBiases;     // HIDDEN2
+    std::vector<int8_t> valueWeights;      // HIDDEN2
+    int32_t valueBias = 0;
+    std::vector<int8_t> policyWeights;     // POLICY_OUTPUTS x HIDDEN2
+    std::vector<int32_t> policyBiases;     // POLICY_OUTPUTS
+};
+
+#endif
@@ -0,0 +1,21 @@
+#include "Evaluation.h"
+#include "../../src/include/PieceSquareTables.h"
+#include <algorithm>
+
+// Material and piece-square scores are kept up to date by make/unmake; only the pawn structure
+// and king shield are looked up here. Middlegame and endgame scores are blended by the phase.
+int Evaluate(const Position& position, PawnTable& pawnTable) {
+    using PieceSquareTables::MAX_PHASE;
+
+    PawnEntry& pawns = pawnTable.probe(position);
+    int middlegame = position.middlegame + pawns.middlegame +
+        pawns.kingShield(position, true) - pawns.kingShield(position, false);
+    int endgame = position.endgame + pawns.endgame;
+
+    // Promotions can take the phase past where the game started
+    int phase = std::min(position.phase, MAX_PHASE);
+    int score = (middlegame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE;
+
+    // moveCount is odd whenever it's white's turn
+    return position.moveCount % 2 != 0 ? score : -score;
+}
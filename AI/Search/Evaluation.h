@@ -0,0 +1,15 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "../../src/include/Position.h"
+#include "PawnTable.h"
+
+// Rough piece values in centipawns for exchange and ordering decisions, indexed by piece type.
+// The evaluation itself uses the tapered values in PieceSquareTables.h.
+const int PIECE_VALUES[7] = { 0, 100, 320, 330, 500, 900, 0 };
+
+// Static score of the position in centipawns, from the side to move's point of view.
+// Pawn structure comes from the calling thread's pawn table.
+int Evaluate(const Position& position, PawnTable& pawnTable);
+
+#endif
@@ -0,0 +1,179 @@
+#include "MovePicker.h"
+#include "Evaluation.h"
+#include "StaticExchange.h"
+#include <cstdlib>
+#include <cstring>
+
+void MoveHistory::clear() {
+    std::memset(butterfly, 0, sizeof(butterfly));
+    std::memset(continuation, 0, sizeof(continuation));
+    for (auto& row : counterMoves) {
+        for (Move& move : row) {
+            move = Move::none();
+        }
+    }
+}
+
+void MoveHistory::update(int16_t& entry, int bonus) {
+    entry += static_cast<int16_t>(bonus - entry * std::abs(bonus) / MAX_HISTORY);
+}
+
+MovePicker::MovePicker(Game& game, Position& position, const MoveHistory& history, Move ttMove,
+                       const Move* killerMoves, int previousPiece, int previousTarget)
+    : game(game), position(position), history(history), stage(Stage::TTMove), ttMove(ttMove),
+      killers{ killerMoves[0], killerMoves[1] }, counterMove(Move::none()),
+      previousPiece(previousPiece), previousTarget(previousTarget), scores{}, cursor(0), badCursor(0) {
+    if (previousPiece != -1) {
+        counterMove = history.counterMoves[Piece::index(previousPiece)][previousTarget];
+    }
+    if (!game.IsLegal(position, ttMove)) {
+        this->ttMove = Move::none();
+        stage = Stage::GenerateCaptures;
+    }
+}
+
+MovePicker::MovePicker(Game& game, Position& position, const MoveHistory& history)
+    : game(game), position(position), history(history), stage(Stage::GenerateQuiescence), ttMove(Move::none()),
+      killers{ Move::none(), Move::none() }, counterMove(Move::none()),
+      previousPiece(-1), previousTarget(0), scores{}, cursor(0), badCursor(0) {}
+
+bool MovePicker::isNoisy(const Position& position, Move move) {
+    return position.board[move.targetSquare()] != Piece::None || move.isEnPassant() || move.isPromotion();
+}
+
+Move MovePicker::next() {
+    switch (stage) {
+    case Stage::TTMove:
+        stage = Stage::GenerateCaptures;
+        return ttMove;
+
+    case Stage::GenerateCaptures:
+        game.GenerateMoves(position, moves, MoveGenType::Captures);
+        scoreCaptures();
+        cursor = 0;
+        stage = Stage::GoodCaptures;
+        // fall through
+    case Stage::GoodCaptures:
+        while (cursor < moves.size()) {
+            Move move = pickBest();
+            if (move == ttMove) {
+                continue;
+            }
+            // Anything that gives up more than it takes waits until the quiet moves have had their turn
+            if (scores[cursor - 1] < 0 || !SeeAtLeast(position, move, 0)) {
+                badCaptures.push_back(move);
+                continue;
+            }
+            return move;
+        }
+        stage = Stage::Killer1;
+        // fall through
+    case Stage::Killer1:
+        stage = Stage::Killer2;
+        if (isUsableQuiet(killers[0])) {
+            return killers[0];
+        }
+        // fall through
+    case Stage::Killer2:
+        stage = Stage::CounterMove;
+        if (killers[1] != killers[0] && isUsableQuiet(killers[1])) {
+            return killers[1];
+        }
+        // fall through
+    case Stage::CounterMove:
+        stage = Stage::GenerateQuiets;
+        if (counterMove != killers[0] && counterMove != killers[1] && isUsableQuiet(counterMove)) {
+            return counterMove;
+        }
+        // fall through
+    case Stage::GenerateQuiets:
+        game.GenerateMoves(position, moves, MoveGenType::Quiets);
+        scoreQuiets();
+        cursor = 0;
+        stage = Stage::Quiets;
+        // fall through
+    case Stage::Quiets:
+        while (cursor < moves.size()) {
+            Move move = pickBest();
+            if (move != ttMove && !isRefutation(move)) {
+                return move;
+            }
+        }
+        stage = Stage::BadCaptures;
+        // fall through
+    case Stage::BadCaptures:
+        if (badCursor < badCaptures.size()) {
+            return badCaptures[badCursor++];
+        }
+        stage = Stage::Done;
+        break;
+
+    case Stage::GenerateQuiescence:
+        game.GenerateMoves(position, moves, MoveGenType::Captures);
+        scoreCaptures();
+        cursor = 0;
+        stage = Stage::Quiescence;
+        // fall through
+    case Stage::Quiescence:
+        if (cursor < moves.size()) {
+            return pickBest();
+        }
+        stage = Stage::Done;
+        // fall through
+    case Stage::Done:
+        break;
+    }
+    return Move::none();
+}
+
+// Most valuable victim first, cheapest attacker first among equal victims. Whether a capture
+// actually loses material is left to the static exchange check when it comes up.
+void MovePicker::scoreCaptures() {
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = moves[i];
+        int attacker = position.board[move.startSquare()] & 7;
+        int victim = move.isEnPassant() ? Piece::Pawn : position.board[move.targetSquare()] & 7;
+        int gain = PIECE_VALUES[victim] + (move.isPromotion() ? PIECE_VALUES[move.promotionType()] - PIECE_VALUES[Piece::Pawn] : 0);
+
+        if (move.isPromotion() && move.promotionType() != Piece::Queen) {
+            scores[i] = -1;   // Underpromotions are almost never best
+        }
+        else {
+            scores[i] = gain * 8 - attacker;
+        }
+    }
+}
+
+void MovePicker::scoreQuiets() {
+    int side = game.IsWhiteMove(position) ? 0 : 1;
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = moves[i];
+        int from = move.startSquare();
+        int to = move.targetSquare();
+        scores[i] = history.butterfly[side][from][to];
+        if (previousPiece != -1) {
+            scores[i] += history.continuation[Piece::index(previousPiece)][previousTarget][Piece::index(position.board[from])][to];
+        }
+    }
+}
+
+Move MovePicker::pickBest() {
+    int best = cursor;
+    for (int i = cursor + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[cursor], moves[best]);
+    std::swap(scores[cursor], scores[best]);
+    return moves[cursor++];
+}
+
+bool MovePicker::isRefutation(Move move) const {
+    return move == killers[0] || move == killers[1] || move == counterMove;
+}
+
+// Killers and countermoves were stored for a different position, so check them before use
+bool MovePicker::isUsableQuiet(Move move) {
+    return !move.isNone() && move != ttMove && !isNoisy(position, move) && game.IsLegal(position, move);
+}
@@ -0,0 +1,69 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "../../src/include/Game.h"
+#include "../../src/include/Position.h"
+#include <cstdint>
+
+const int MAX_HISTORY = 16384;
+
+// Per-thread move ordering statistics, filled in by the search as quiet moves cause cutoffs
+struct MoveHistory {
+    int16_t butterfly[2][64][64];              // [side][from][to]
+    int16_t continuation[12][64][12][64];      // [previous piece][previous target][piece][target]
+    Move counterMoves[12][64];                 // [previous piece][previous target]
+
+    void clear();
+
+    // Moves the entry towards +/-MAX_HISTORY by bonus, more slowly the closer it already is
+    static void update(int16_t& entry, int bonus);
+};
+
+// Hands out the moves of a node one at a time, best guess first, and only generates a group
+// of moves once the ones before it have failed to cut off:
+//   hash move, good captures (MVV-LVA), two killers, countermove, quiets by history, bad captures
+// Captures that lose material by static exchange are the bad ones.
+class MovePicker {
+public:
+    // previousPiece is -1 at the root or after a null move
+    MovePicker(Game& game, Position& position, const MoveHistory& history, Move ttMove,
+               const Move* killers, int previousPiece, int previousTarget);
+
+    // Captures and promotions only, by MVV-LVA, for the quiescence search
+    MovePicker(Game& game, Position& position, const MoveHistory& history);
+
+    // Move::none() once every move has been returned
+    Move next();
+
+    // Captures, en passant and promotions
+    static bool isNoisy(const Position& position, Move move);
+
+private:
+    enum class Stage { TTMove, GenerateCaptures, GoodCaptures, Killer1, Killer2, CounterMove,
+                       GenerateQuiets, Quiets, BadCaptures, GenerateQuiescence, Quiescence, Done };
+
+    void scoreCaptures();
+    void scoreQuiets();
+    // Swaps the best remaining move to the cursor and returns it
+    Move pickBest();
+    bool isRefutation(Move move) const;
+    bool isUsableQuiet(Move move);
+
+    Game& game;
+    Position& position;
+    const MoveHistory& history;
+    Stage stage;
+    Move ttMove;
+    Move killers[2];
+    Move counterMove;
+    int previousPiece;
+    int previousTarget;
+
+    MoveList moves;
+    int scores[MAX_MOVES];
+    int cursor;
+    MoveList badCaptures;
+    int badCursor;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "PawnTable.h"
+#include <algorithm>
+
+namespace {
+    const int PASSED_MIDDLEGAME[8] = { 0, 5, 10, 15, 25, 45, 70, 0 };   // By rank from the pawn's own side
+    const int PASSED_ENDGAME[8] = { 0, 10, 20, 35, 60, 100, 150, 0 };
+    const int DOUBLED_MIDDLEGAME = -10, DOUBLED_ENDGAME = -20;
+    const int ISOLATED_MIDDLEGAME = -10, ISOLATED_ENDGAME = -15;
+    const int BACKWARD_MIDDLEGAME = -8, BACKWARD_ENDGAME = -10;
+    const int SHIELD_NEAR = 15, SHIELD_FAR = 8;                         // One and two ranks in front of the king
+
+    // "Forward" is north for white and south for black; the fills include the squares they start from
+    Bitboard forwardOne(Bitboard b, bool white) { return white ? b >> 8 : b << 8; }
+    Bitboard forwardFill(Bitboard b, bool white) {
+        if (white) {
+            b |= b >> 8; b |= b >> 16; b |= b >> 32;
+        }
+        else {
+            b |= b << 8; b |= b << 16; b |= b << 32;
+        }
+        return b;
+    }
+    Bitboard backwardFill(Bitboard b, bool white) { return forwardFill(b, !white); }
+    Bitboard sideways(Bitboard b) { return BitboardOps::eastOne(b) | BitboardOps::westOne(b); }
+    Bitboard pawnAttacks(Bitboard pawns, bool white) { return sideways(forwardOne(pawns, white)); }
+    int relativeRank(int square, bool white) { return white ? 7 - square / 8 : square / 8; }
+
+    // Set-wise terms for one side's pawns, from that side's point of view
+    void evaluateSide(const Position& position, bool white, PawnEntry& entry, int& middlegame, int& endgame) {
+        Bitboard ours = white ? position.bitboards.WhitePawns : position.bitboards.BlackPawns;
+        Bitboard theirs = white ? position.bitboards.BlackPawns : position.bitboards.WhitePawns;
+
+        Bitboard behindOurs = backwardFill(forwardOne(ours, !white), white);   // Strictly behind one of ours
+        Bitboard theirFronts = forwardFill(forwardOne(theirs, !white), !white); // Strictly ahead of theirs, as they see it
+        Bitboard ourFiles = forwardFill(ours, true) | forwardFill(ours, false);
+
+        Bitboard doubled = ours & behindOurs;
+        Bitboard isolated = ours & ~sideways(ourFiles);
+        // Nothing on a neighbouring file level with it or behind can come up to defend it, and
+        // stepping forward walks into an enemy pawn's capture
+        Bitboard supportable = ours & forwardFill(sideways(ours), white);
+        Bitboard backward = ours & ~supportable & ~isolated & forwardOne(pawnAttacks(theirs, !white), !white);
+        // No enemy pawn ahead on its own or a neighbouring file; of doubled pawns only the front one counts
+        Bitboard passed = ours & ~(theirFronts | sideways(theirFronts)) & ~doubled;
+
+        middlegame += doubled.count() * DOUBLED_MIDDLEGAME + isolated.count() * ISOLATED_MIDDLEGAME +
+            backward.count() * BACKWARD_MIDDLEGAME;
+        endgame += doubled.count() * DOUBLED_ENDGAME + isolated.count() * ISOLATED_ENDGAME +
+            backward.count() * BACKWARD_ENDGAME;
+        for (Bitboard remaining = passed; !remaining.empty();) {
+            int rank = relativeRank(remaining.popLsb(), white);
+            middlegame += PASSED_MIDDLEGAME[rank];
+            endgame += PASSED_ENDGAME[rank];
+        }
+        entry.passed[white ? 0 : 1] = passed;
+    }
+}
+
+int PawnEntry::kingShield(const Position& position, bool white) {
+    int side = white ? 0 : 1;
+    int kingSquare = position.kingSquares[side];
+    if (kingSquare == shieldSquare[side]) {
+        return shieldScore[side];
+    }
+
+    Bitboard ours = white ? position.bitboards.WhitePawns : position.bitboards.BlackPawns;
+    Bitboard files = Bitboard::fromSquare(kingSquare) | sideways(Bitboard::fromSquare(kingSquare));
+    Bitboard near = forwardOne(files, white);
+    Bitboard far = forwardOne(near, white);
+
+    shieldSquare[side] = kingSquare;
+    shieldScore[side] = (ours & near).count() * SHIELD_NEAR + (ours & far).count() * SHIELD_FAR;
+    return shieldScore[side];
+}
+
+PawnTable::PawnTable()
+    : entries(SIZE) {}
+
+void PawnTable::clear() {
+    std::fill(entries.begin(), entries.end(), PawnEntry());
+}
+
+PawnEntry& PawnTable::probe(const Position& position) {
+    // An empty slot has key 0 and zero scores, which is also the right answer for no pawns at all
+    PawnEntry& entry = entries[position.pawnKey & (SIZE - 1)];
+    if (entry.key == position.pawnKey) {
+        return entry;
+    }
+
+    entry = PawnEntry();
+    entry.key = position.pawnKey;
+    int whiteMiddlegame = 0, whiteEndgame = 0, blackMiddlegame = 0, blackEndgame = 0;
+    evaluateSide(position, true, entry, whiteMiddlegame, whiteEndgame);
+    evaluateSide(position, false, entry, blackMiddlegame, blackEndgame);
+    entry.middlegame = whiteMiddlegame - blackMiddlegame;
+    entry.endgame = whiteEndgame - blackEndgame;
+    return entry;
+}
@@ -0,0 +1,41 @@
+#ifndef PAWN_TABLE_H
+#define PAWN_TABLE_H
+
+#include "../../src/include/Position.h"
+#include <cstdint>
+#include <vector>
+
+// Everything about a pawn configuration that doesn't depend on the other pieces. Scores are
+// white minus black, split into middlegame and endgame parts.
+struct PawnEntry {
+    uint64_t key = 0;
+    int middlegame = 0;
+    int endgame = 0;
+    Bitboard passed[2];             // White, black
+
+    // The shield also depends on where the king stands, so it is worked out on first use for
+    // each king square and kept until the king moves
+    int shieldSquare[2] = { -1, -1 };
+    int shieldScore[2] = { 0, 0 };
+
+    // Middlegame bonus for pawns sheltering the given side's king
+    int kingShield(const Position& position, bool white);
+};
+
+// Direct-mapped cache of PawnEntry keyed on Position::pawnKey. One per search thread, so no
+// locking is needed; pawn moves are rare enough that nearly every probe hits.
+class PawnTable {
+public:
+    PawnTable();
+
+    // The entry for the position's pawns, evaluating them first on a miss
+    PawnEntry& probe(const Position& position);
+    void clear();
+
+private:
+    static const int SIZE = 1 << 14;
+
+    std::vector<PawnEntry> entries;
+};
+
+#endif
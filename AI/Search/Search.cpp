@@ -0,0 +1,420 @@
+#include "Search.h"
+#include "Evaluation.h"
+#include "StaticExchange.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+const std::vector<TunableParameter>& TunableParameters() {
+    static const std::vector<TunableParameter> parameters = {
+        { "NullMoveMinDepth", &SearchParameters::nullMoveMinDepth, 1, 10 },
+        { "NullMoveReduction", &SearchParameters::nullMoveReduction, 1, 6 },
+        { "NullMoveDepthDivisor", &SearchParameters::nullMoveDepthDivisor, 1, 12 },
+        { "ReverseFutilityMaxDepth", &SearchParameters::reverseFutilityMaxDepth, 0, 16 },
+        { "ReverseFutilityMargin", &SearchParameters::reverseFutilityMargin, 0, 500 },
+        { "FutilityMaxDepth", &SearchParameters::futilityMaxDepth, 0, 16 },
+        { "FutilityBase", &SearchParameters::futilityBase, 0, 500 },
+        { "FutilityMargin", &SearchParameters::futilityMargin, 0, 500 },
+        { "LateMovePruningMaxDepth", &SearchParameters::lateMovePruningMaxDepth, 0, 16 },
+        { "LateMovePruningBase", &SearchParameters::lateMovePruningBase, 1, 20 },
+        { "LmrMinDepth", &SearchParameters::lmrMinDepth, 1, 10 },
+        { "LmrMinMoves", &SearchParameters::lmrMinMoves, 1, 20 },
+        { "LmrBase", &SearchParameters::lmrBase, 0, 300 },
+        { "LmrDivisor", &SearchParameters::lmrDivisor, 50, 1000 },
+    };
+    return parameters;
+}
+
+Search::Search(TranspositionTable& tt, int threadIndex)
+    : tt(tt), threadIndex(threadIndex), stopped(false), nodes(0), rootBestMove(Move::none()),
+      history(std::make_unique<MoveHistory>()), pawnTable(std::make_unique<PawnTable>()), killers{}, stack{}, pvLength{} {
+    history->clear();
+    setParameters(SearchParameters());
+}
+
+void Search::setParameters(const SearchParameters& searchParameters) {
+    parameters = searchParameters;
+    for (int depth = 0; depth < 64; depth++) {
+        for (int moves = 0; moves < 64; moves++) {
+            double logProduct = depth > 0 && moves > 0 ? std::log(depth) * std::log(moves) : 0.0;
+            reductions[depth][moves] = static_cast<int>((parameters.lmrBase + logProduct * 100.0 * 100.0 / parameters.lmrDivisor) / 100.0);
+        }
+    }
+}
+
+void Search::prepare(const Position& root, const SearchLimits& searchLimits) {
+    position = root;
+    limits = searchLimits;
+    timeManager.start(limits);
+    stopped = false;
+    nodes = 0;
+    rootBestMove = Move::none();
+    std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move::none());
+}
+
+void Search::stop() {
+    stopped = true;
+}
+
+// Searches one ply deeper each iteration until a limit is hit. An iteration that gets cut off
+// is thrown away, except that a best move found by it is still better than none.
+SearchResult Search::think(const InfoCallback& onIteration) {
+    SearchResult result;
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (skipsDepth(depth)) {
+            continue;
+        }
+
+        int score = negamax(depth, 0, -INFINITE_SCORE, INFINITE_SCORE);
+
+        if (stopped) {
+            if (result.bestMove.isNone() && pvLength[0] > 0) {
+                result.bestMove = pvTable[0][0];
+            }
+            break;
+        }
+
+        result.depth = depth;
+        result.score = score;
+        result.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        result.bestMove = result.pv.empty() ? Move::none() : result.pv[0];
+        rootBestMove = result.bestMove;
+
+        if (onIteration) {
+            onIteration({ depth, score, nodeCount(), timeManager.elapsed(), tt.hashfull(), result.pv });
+        }
+
+        // No legal moves, or a forced mate already found: deeper iterations can't change anything
+        if (result.pv.empty() || std::abs(score) >= MATE_BOUND) {
+            break;
+        }
+        if (!timeManager.canStartIteration()) {
+            break;
+        }
+    }
+
+    // An infinite search may not report before it is told to stop, even with a mate in hand or
+    // the depth cap reached, since UCI forbids bestmove before "stop"
+    if (limits.infinite) {
+        while (!stopped) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Stopped before even one move was searched: any legal move beats resigning by default
+    if (result.bestMove.isNone()) {
+        MoveList moves;
+        game.GenerateMoves(position, moves);
+        if (!moves.empty()) {
+            result.bestMove = moves[0];
+            result.pv = { moves[0] };
+        }
+    }
+
+    result.nodes = nodeCount();
+    return result;
+}
+
+int Search::negamax(int depth, int ply, int alpha, int beta) {
+    pvLength[ply] = 0;
+    if (depth <= 0) {
+        return quiescence(ply, alpha, beta);
+    }
+    if (!visitNode()) {
+        return 0;
+    }
+
+    if (ply > 0 && (position.gameFlags.halfMoveClock >= 100 || position.isRepetition())) {
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1) {
+        return Evaluate(position, *pawnTable);
+    }
+
+    // A deep enough result for this position ends the search here, except on the PV where
+    // we want the line itself and not just the score
+    bool pvNode = beta - alpha > 1;
+    TTEntry ttEntry;
+    Move ttMove = Move::none();
+    if (tt.probe(position.key, ttEntry)) {
+        ttMove = ttEntry.move;
+        int ttScore = ScoreFromTT(ttEntry.score, ply);
+        if (!pvNode && ttEntry.depth >= depth &&
+            (ttEntry.bound == Bound::Exact ||
+             (ttEntry.bound == Bound::Lower && ttScore >= beta) ||
+             (ttEntry.bound == Bound::Upper && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+
+    bool inCheck = game.IsKingInCheck(position, isWhiteToMove() ? Piece::White : Piece::Black);
+    int staticEval = inCheck ? -INFINITE_SCORE : Evaluate(position, *pawnTable);
+    const SearchParameters& p = parameters;
+
+    if (!pvNode && !inCheck) {
+        // Reverse futility: so far above beta that a shallow search won't bring it back down
+        if (depth <= p.reverseFutilityMaxDepth && std::abs(beta) < MATE_BOUND &&
+            staticEval - p.reverseFutilityMargin * depth >= beta) {
+            return staticEval;
+        }
+
+        // Null move: if passing still fails high, a real move almost certainly would. Not with only
+        // pawns left, where passing may be the only thing that doesn't lose (zugzwang), and never
+        // twice in a row.
+        if (depth >= p.nullMoveMinDepth && staticEval >= beta && ply > 0 && stack[ply - 1].movedPiece != -1 &&
+            hasNonPawnMaterial()) {
+            int reduction = p.nullMoveReduction + depth / p.nullMoveDepthDivisor;
+            stack[ply] = { -1, 0 };
+            game.MakeNullMove(position);
+            int score = -negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+            game.UnmakeNullMove(position);
+            if (stopped) {
+                return 0;
+            }
+            if (score >= beta) {
+                return score >= MATE_BOUND ? beta : score;   // Don't trust a mate found by passing
+            }
+        }
+    }
+
+    // At the root the previous iteration's best move goes first, so the PV is searched with a full window
+    if (ply == 0 && !rootBestMove.isNone()) {
+        ttMove = rootBestMove;
+    }
+    int previousPiece = ply > 0 ? stack[ply - 1].movedPiece : -1;
+    int previousTarget = ply > 0 ? stack[ply - 1].target : 0;
+    MovePicker picker(game, position, *history, ttMove, killers[ply], previousPiece, previousTarget);
+
+    int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove = Move::none();
+    int moveCount = 0;
+    Move quietsTried[64];
+    int quietCount = 0;
+
+    for (Move move = picker.next(); !move.isNone(); move = picker.next()) {
+        bool noisy = MovePicker::isNoisy(position, move);
+
+        // Late quiet moves at shallow depth are skipped outright once a line that avoids being
+        // mated is in hand: after enough of them, or when even a good gain couldn't reach alpha
+        if (!pvNode && !inCheck && !noisy && bestScore > -MATE_BOUND) {
+            if (depth <= p.lateMovePruningMaxDepth && moveCount >= p.lateMovePruningBase + depth * depth) {
+                continue;
+            }
+            if (depth <= p.futilityMaxDepth && staticEval + p.futilityBase + p.futilityMargin * depth <= alpha) {
+                continue;
+            }
+        }
+
+        stack[ply] = { position.board[move.startSquare()], move.targetSquare() };
+        game.MakeMove(position, move);
+        moveCount++;
+
+        // Only the first move gets the full window. The rest just have to prove they're no better,
+        // and are searched again properly if they turn out to be. Late quiet moves get to prove it
+        // with a shallower search first.
+        int newDepth = depth - 1;
+        int score;
+        if (moveCount == 1) {
+            score = -negamax(newDepth, ply + 1, -beta, -alpha);
+        }
+        else {
+            int reduction = 0;
+            if (depth >= p.lmrMinDepth && moveCount > p.lmrMinMoves && !noisy && !inCheck) {
+                reduction = reductions[std::min(depth, 63)][std::min(moveCount, 63)] - (pvNode ? 1 : 0);
+                reduction = std::max(0, std::min(reduction, newDepth - 1));
+            }
+            score = -negamax(newDepth - reduction, ply + 1, -alpha - 1, -alpha);
+            if (reduction > 0 && score > alpha) {
+                score = -negamax(newDepth, ply + 1, -alpha - 1, -alpha);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(newDepth, ply + 1, -beta, -alpha);
+            }
+        }
+
+        game.UnmakeMove(position, move);
+
+        if (stopped) {
+            return 0;
+        }
+        if (!noisy && quietCount < 64) {
+            quietsTried[quietCount++] = move;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                pvTable[ply][0] = move;
+                std::copy(pvTable[ply + 1], pvTable[ply + 1] + pvLength[ply + 1], pvTable[ply] + 1);
+                pvLength[ply] = pvLength[ply + 1] + 1;
+
+                if (alpha >= beta) {
+                    if (!noisy) {
+                        updateQuietStats(ply, depth, move, quietsTried, quietCount);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (moveCount == 0) {
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    Bound bound = bestScore >= beta ? Bound::Lower : (bestScore > originalAlpha ? Bound::Exact : Bound::Upper);
+    tt.store(position.key, bestMove, ScoreToTT(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+// Out of check only captures are searched, and the side to move may "stand pat" on the static
+// evaluation instead, since it could normally play some quiet move that keeps at least that much.
+// In check there is no such choice, so every evasion is searched and a mate is found as a mate.
+int Search::quiescence(int ply, int alpha, int beta) {
+    pvLength[ply] = 0;
+    if (!visitNode()) {
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1) {
+        return Evaluate(position, *pawnTable);
+    }
+
+    bool inCheck = game.IsKingInCheck(position, isWhiteToMove() ? Piece::White : Piece::Black);
+    int bestScore = -INFINITE_SCORE;
+    int standPat = 0;
+    if (!inCheck) {
+        standPat = Evaluate(position, *pawnTable);
+        if (standPat >= beta) {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+        bestScore = standPat;
+    }
+
+    int previousPiece = ply > 0 ? stack[ply - 1].movedPiece : -1;
+    int previousTarget = ply > 0 ? stack[ply - 1].target : 0;
+    MovePicker picker = inCheck
+        ? MovePicker(game, position, *history, Move::none(), killers[ply], previousPiece, previousTarget)
+        : MovePicker(game, position, *history);
+
+    int moveCount = 0;
+    for (Move move = picker.next(); !move.isNone(); move = picker.next()) {
+        if (!inCheck) {
+            if (move.isPromotion() && move.promotionType() != Piece::Queen) {
+                continue;
+            }
+            // Delta pruning: even winning the victim for free wouldn't bring the score up to alpha
+            int victim = move.isEnPassant() ? Piece::Pawn : position.board[move.targetSquare()] & 7;
+            if (!move.isPromotion() && standPat + PIECE_VALUES[victim] + DELTA_MARGIN <= alpha) {
+                continue;
+            }
+            if (!SeeAtLeast(position, move, 0)) {
+                continue;
+            }
+        }
+
+        stack[ply] = { position.board[move.startSquare()], move.targetSquare() };
+        game.MakeMove(position, move);
+        moveCount++;
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        game.UnmakeMove(position, move);
+
+        if (stopped) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (inCheck && moveCount == 0) {
+        return -MATE_SCORE + ply;
+    }
+    return bestScore;
+}
+
+// Plain load and store rather than fetch_add: only this thread writes the counter
+bool Search::visitNode() {
+    uint64_t nodeTotal = nodes.load(std::memory_order_relaxed) + 1;
+    nodes.store(nodeTotal, std::memory_order_relaxed);
+    if ((nodeTotal & 1023) == 0) {
+        checkLimits();
+    }
+    return !stopped;
+}
+
+void Search::checkLimits() {
+    if (timeManager.outOfTime() || (limits.nodes > 0 && nodeCount() >= limits.nodes)) {
+        stopped = true;
+    }
+}
+
+// Helper i follows one row of a fixed pattern of skipped depths, so at any moment the helpers
+// are spread over the current iteration and the next few instead of duplicating the main thread
+bool Search::skipsDepth(int depth) const {
+    static const int SKIP_SIZE[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    static const int SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    if (threadIndex == 0) {
+        return false;
+    }
+    int row = (threadIndex - 1) % 20;
+    return ((depth + SKIP_PHASE[row]) / SKIP_SIZE[row]) % 2 != 0;
+}
+
+// The quiet move that cut off is rewarded in every table; the quiets tried before it are
+// penalised by the same amount, so moves that never cut off sink down the order
+void Search::updateQuietStats(int ply, int depth, Move best, const Move* quiets, int quietCount) {
+    if (killers[ply][0] != best) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = best;
+    }
+
+    int previousPiece = ply > 0 ? stack[ply - 1].movedPiece : -1;
+    int previousTarget = ply > 0 ? stack[ply - 1].target : 0;
+    if (previousPiece != -1) {
+        history->counterMoves[Piece::index(previousPiece)][previousTarget] = best;
+    }
+
+    int side = isWhiteToMove() ? 0 : 1;
+    int bonus = std::min(16 * depth * depth, 1200);
+    for (int i = 0; i < quietCount; i++) {
+        Move move = quiets[i];
+        int from = move.startSquare();
+        int to = move.targetSquare();
+        int change = move == best ? bonus : -bonus;
+        MoveHistory::update(history->butterfly[side][from][to], change);
+        if (previousPiece != -1) {
+            MoveHistory::update(history->continuation[Piece::index(previousPiece)][previousTarget][Piece::index(position.board[from])][to], change);
+        }
+    }
+}
+
+void Search::clearHistory() {
+    history->clear();
+    pawnTable->clear();
+}
+
+bool Search::hasNonPawnMaterial() const {
+    const PieceBitboards& bb = position.bitboards;
+    if (isWhiteToMove()) {
+        return !(bb.WhiteKnights | bb.WhiteBishops | bb.WhiteRooks | bb.WhiteQueens).empty();
+    }
+    return !(bb.BlackKnights | bb.BlackBishops | bb.BlackRooks | bb.BlackQueens).empty();
+}
+
+bool Search::isWhiteToMove() const {
+    return game.IsWhiteMove(position);
+}
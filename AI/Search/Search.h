@@ -0,0 +1,136 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "../../src/include/Game.h"
+#include "../../src/include/Position.h"
+#include "MovePicker.h"
+#include "PawnTable.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+const int MAX_PLY = 128;
+const int INFINITE_SCORE = 32000;
+const int MATE_SCORE = 31000;                     // Mate at ply n scores MATE_SCORE - n
+const int MATE_BOUND = MATE_SCORE - MAX_PLY;      // Anything beyond this is a forced mate
+const int DELTA_MARGIN = 200;                     // Quiescence skips captures that can't get within this of alpha
+
+// Thresholds of the selective search. Depths are in plies and margins in centipawns; the
+// reduction formula uses hundredths so it can be tuned in whole numbers.
+struct SearchParameters {
+    int nullMoveMinDepth = 3;
+    int nullMoveReduction = 3;          // Plus one more ply for every nullMoveDepthDivisor plies of depth
+    int nullMoveDepthDivisor = 4;
+    int reverseFutilityMaxDepth = 7;
+    int reverseFutilityMargin = 80;     // Per ply of depth
+    int futilityMaxDepth = 6;
+    int futilityBase = 100;
+    int futilityMargin = 90;            // Per ply of depth
+    int lateMovePruningMaxDepth = 6;
+    int lateMovePruningBase = 3;        // Quiet moves searched at depth d: base + d * d
+    int lmrMinDepth = 3;
+    int lmrMinMoves = 3;                // Moves searched in full before reductions start
+    int lmrBase = 75;                   // Reduction = (base + ln(depth) * ln(moves) * 100 / divisor) / 100
+    int lmrDivisor = 225;
+};
+
+// A SearchParameters field under the name UCI's setoption uses for it, for tuning from outside
+struct TunableParameter {
+    const char* name;
+    int SearchParameters::* field;
+    int min;
+    int max;
+};
+
+const std::vector<TunableParameter>& TunableParameters();
+
+// Reported after every completed iteration
+struct SearchInfo {
+    int depth;
+    int score;
+    uint64_t nodes;
+    int64_t time;       // Milliseconds since the search started
+    int hashfull;       // Transposition table use in per mille
+    std::vector<Move> pv;
+};
+
+struct SearchResult {
+    Move bestMove = Move::none();
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    std::vector<Move> pv;
+};
+
+// Iterative deepening negamax with principal variation search. One Search is one thread's worth
+// of state; ThreadPool runs several of them on the same root.
+class Search {
+public:
+    using InfoCallback = std::function<void(const SearchInfo&)>;
+
+    // Thread 0 is the main search. Helpers skip some depths so they spread out over the tree
+    // instead of all searching the same iteration.
+    Search(TranspositionTable& tt, int threadIndex = 0);
+
+    // Copies the root and starts the clock. Split from think() so the caller can hand the search
+    // to another thread while still being able to stop() it straight away.
+    void prepare(const Position& root, const SearchLimits& limits);
+    SearchResult think(const InfoCallback& onIteration = nullptr);
+
+    // Safe to call from any thread
+    void stop();
+    uint64_t nodeCount() const { return nodes.load(std::memory_order_relaxed); }
+
+    // Forget the move ordering statistics and cached pawn structures, e.g. for a new game.
+    // Only between searches.
+    void clearHistory();
+
+    // Only between searches
+    void setParameters(const SearchParameters& searchParameters);
+
+private:
+    int negamax(int depth, int ply, int alpha, int beta);
+    // Resolves captures at the leaves so the static evaluation never sees a half-finished exchange
+    int quiescence(int ply, int alpha, int beta);
+    // Counts the node and polls the limits every so often. False once the search has to stop.
+    bool visitNode();
+    void checkLimits();
+    bool isWhiteToMove() const;
+    bool skipsDepth(int depth) const;
+    bool hasNonPawnMaterial() const;
+    void updateQuietStats(int ply, int depth, Move best, const Move* quiets, int quietCount);
+
+    // What was played to reach each ply, for the countermove and continuation history lookups
+    struct StackEntry {
+        int movedPiece;
+        int target;
+    };
+
+    Game game;
+    TranspositionTable& tt;
+    int threadIndex;
+    Position position;
+    SearchLimits limits;
+    SearchParameters parameters;
+    int reductions[64][64];             // Late move reduction by [depth][moves searched]
+    TimeManager timeManager;
+    std::atomic<bool> stopped;
+    std::atomic<uint64_t> nodes;  // Only written by the owning thread; atomic so others can read it
+    Move rootBestMove;
+
+    // Move ordering state belongs to the thread, so helpers never contend on it
+    std::unique_ptr<MoveHistory> history;
+    std::unique_ptr<PawnTable> pawnTable;
+    Move killers[MAX_PLY][2];
+    StackEntry stack[MAX_PLY];
+
+    // Triangular PV table: pvTable[ply] holds the line found from that ply on
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "StaticExchange.h"
+#include "Evaluation.h"
+
+bool SeeAtLeast(const Position& position, Move move, int threshold) {
+    if (move.isCastling()) {
+        return threshold <= 0;
+    }
+
+    int from = move.startSquare();
+    int to = move.targetSquare();
+    int moving = position.board[from];
+    bool white = (moving & 0b11000) == Piece::White;
+    int capturedSquare = move.isEnPassant() ? (white ? to + 8 : to - 8) : to;
+
+    // swap is what the side to move at each step stands to gain if the exchange stopped right
+    // there, relative to the threshold. The first capture is always made.
+    int gain = PIECE_VALUES[position.board[capturedSquare] & 7];
+    int onSquare = moving & 7;
+    if (move.isPromotion()) {
+        gain += PIECE_VALUES[move.promotionType()] - PIECE_VALUES[Piece::Pawn];
+        onSquare = move.promotionType();
+    }
+    int swap = gain - threshold;
+    if (swap < 0) {
+        return false;
+    }
+    swap = PIECE_VALUES[onSquare] - swap;
+    if (swap <= 0) {
+        return true;
+    }
+
+    const PieceBitboards& bb = position.bitboards;
+    Bitboard diagonal = bb.WhiteBishops | bb.BlackBishops | bb.WhiteQueens | bb.BlackQueens;
+    Bitboard orthogonal = bb.WhiteRooks | bb.BlackRooks | bb.WhiteQueens | bb.BlackQueens;
+    Bitboard occupancy = (position.occupancy() ^ Bitboard::fromSquare(from) ^ Bitboard::fromSquare(capturedSquare)) |
+        Bitboard::fromSquare(to);
+    Bitboard attackers = position.attackersTo(to, occupancy);
+
+    // result flips with every capture; it is 1 while the side that moved first comes out ahead
+    // if the side to recapture gives up here
+    int result = 1;
+    bool whiteToCapture = white;
+    while (true) {
+        whiteToCapture = !whiteToCapture;
+        attackers &= occupancy;
+        Bitboard ours = attackers & position.colorOccupancy(whiteToCapture);
+        if (ours.empty()) {
+            break;
+        }
+        result ^= 1;
+
+        Bitboard candidates;
+        if (!(candidates = ours & (bb.WhitePawns | bb.BlackPawns)).empty()) {
+            if ((swap = PIECE_VALUES[Piece::Pawn] - swap) < result) {
+                break;
+            }
+            occupancy ^= Bitboard::fromSquare(candidates.lsb());
+            attackers |= BitboardOps::bishopAttacks(to, occupancy) & diagonal;
+        }
+        else if (!(candidates = ours & (bb.WhiteKnights | bb.BlackKnights)).empty()) {
+            if ((swap = PIECE_VALUES[Piece::Knight] - swap) < result) {
+                break;
+            }
+            occupancy ^= Bitboard::fromSquare(candidates.lsb());
+        }
+        else if (!(candidates = ours & (bb.WhiteBishops | bb.BlackBishops)).empty()) {
+            if ((swap = PIECE_VALUES[Piece::Bishop] - swap) < result) {
+                break;
+            }
+            occupancy ^= Bitboard::fromSquare(candidates.lsb());
+            attackers |= BitboardOps::bishopAttacks(to, occupancy) & diagonal;
+        }
+        else if (!(candidates = ours & (bb.WhiteRooks | bb.BlackRooks)).empty()) {
+            if ((swap = PIECE_VALUES[Piece::Rook] - swap) < result) {
+                break;
+            }
+            occupancy ^= Bitboard::fromSquare(candidates.lsb());
+            attackers |= BitboardOps::rookAttacks(to, occupancy) & orthogonal;
+        }
+        else if (!(candidates = ours & (bb.WhiteQueens | bb.BlackQueens)).empty()) {
+            if ((swap = PIECE_VALUES[Piece::Queen] - swap) < result) {
+                break;
+            }
+            occupancy ^= Bitboard::fromSquare(candidates.lsb());
+            attackers |= (BitboardOps::bishopAttacks(to, occupancy) & diagonal) |
+                (BitboardOps::rookAttacks(to, occupancy) & orthogonal);
+        }
+        else {
+            // Only the king is left: it may capture only if the other side has nothing to take back with
+            return ((attackers & position.colorOccupancy(!whiteToCapture)).empty() ? result : result ^ 1) != 0;
+        }
+    }
+    return result != 0;
+}
@@ -0,0 +1,14 @@
+#ifndef STATIC_EXCHANGE_H
+#define STATIC_EXCHANGE_H
+
+#include "../../src/include/Position.h"
+
+// Static exchange evaluation: plays out the captures on the move's target square, each side
+// always recapturing with its least valuable piece and free to stop when recapturing would
+// lose material. Sliders behind the pieces that have already captured join in as x-rays.
+//
+// True when the exchange wins at least threshold centipawns for the side making the move.
+// Comparing against a threshold lets most exchanges be decided without playing them out.
+bool SeeAtLeast(const Position& position, Move move, int threshold);
+
+#endif
@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <thread>
+
+ThreadPool::ThreadPool(TranspositionTable& tt, int threadCount)
+    : tt(tt) {
+    setThreadCount(threadCount);
+}
+
+void ThreadPool::setThreadCount(int threadCount) {
+    searches.clear();
+    for (int i = 0; i < std::max(1, threadCount); i++) {
+        searches.push_back(std::make_unique<Search>(tt, i));
+        searches.back()->setParameters(parameters);
+    }
+}
+
+// Helpers get no clock and no node budget of their own; they run until the main search stops them
+void ThreadPool::prepare(const Position& root, const SearchLimits& limits) {
+    tt.newSearch();
+    searches[0]->prepare(root, limits);
+
+    SearchLimits helperLimits;
+    helperLimits.depth = limits.depth;
+    helperLimits.infinite = true;
+    for (size_t i = 1; i < searches.size(); i++) {
+        searches[i]->prepare(root, helperLimits);
+    }
+}
+
+SearchResult ThreadPool::think(const Search::InfoCallback& onIteration) {
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < searches.size(); i++) {
+        Search* search = searches[i].get();
+        helpers.emplace_back([search]() { search->think(); });
+    }
+
+    // Node counts in the main search's reports cover every thread
+    SearchResult result = searches[0]->think([&](const SearchInfo& info) {
+        if (onIteration) {
+            SearchInfo total = info;
+            total.nodes = nodeCount();
+            onIteration(total);
+        }
+    });
+
+    for (size_t i = 1; i < searches.size(); i++) {
+        searches[i]->stop();
+    }
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = nodeCount();
+    return result;
+}
+
+SearchResult ThreadPool::run(const Position& root, const SearchLimits& limits, const Search::InfoCallback& onIteration) {
+    prepare(root, limits);
+    return think(onIteration);
+}
+
+void ThreadPool::clear() {
+    for (auto& search : searches) {
+        search->clearHistory();
+    }
+}
+
+void ThreadPool::setParameters(const SearchParameters& searchParameters) {
+    parameters = searchParameters;
+    for (auto& search : searches) {
+        search->setParameters(parameters);
+    }
+}
+
+void ThreadPool::stop() {
+    for (auto& search : searches) {
+        search->stop();
+    }
+}
+
+uint64_t ThreadPool::nodeCount() const {
+    uint64_t total = 0;
+    for (const auto& search : searches) {
+        total += search->nodeCount();
+    }
+    return total;
+}
@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "Search.h"
+#include "TranspositionTable.h"
+#include <memory>
+#include <vector>
+
+// Lazy SMP: every thread searches the same root with its own Search and position copy, and
+// they help each other only through the shared transposition table. The main search keeps the
+// clock and decides when everyone stops; its result is the one returned.
+class ThreadPool {
+public:
+    explicit ThreadPool(TranspositionTable& tt, int threadCount = 1);
+
+    // Only between searches
+    void setThreadCount(int threadCount);
+    int threadCount() const { return static_cast<int>(searches.size()); }
+
+    void prepare(const Position& root, const SearchLimits& limits);
+    SearchResult think(const Search::InfoCallback& onIteration = nullptr);
+    SearchResult run(const Position& root, const SearchLimits& limits, const Search::InfoCallback& onIteration = nullptr);
+
+    // Clears every thread's move ordering statistics and pawn table. Only between searches.
+    void clear();
+
+    // Only between searches
+    void setParameters(const SearchParameters& searchParameters);
+    const SearchParameters& searchParameters() const { return parameters; }
+
+    // Safe to call from any thread
+    void stop();
+    uint64_t nodeCount() const;
+
+private:
+    TranspositionTable& tt;
+    SearchParameters parameters;
+    std::vector<std::unique_ptr<Search>> searches;  // searches[0] is the main search
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+TimeManager::TimeManager()
+    : startTime(std::chrono::steady_clock::now()), optimum(0), maximum(0), limited(false) {}
+
+void TimeManager::start(const SearchLimits& limits) {
+    startTime = std::chrono::steady_clock::now();
+    limited = !limits.infinite && (limits.moveTime >= 0 || limits.timeLeft >= 0);
+
+    if (limits.moveTime >= 0) {
+        optimum = maximum = std::max<int64_t>(1, limits.moveTime - MOVE_OVERHEAD);
+        return;
+    }
+    if (limits.timeLeft < 0) {
+        optimum = maximum = 0;
+        return;
+    }
+
+    // Aim for an even share of the clock plus most of the increment. We may overrun that
+    // share a few times over when an iteration is still busy, but never eat into the reserve.
+    int64_t available = std::max<int64_t>(1, limits.timeLeft - MOVE_OVERHEAD);
+    int movesToGo = limits.movesToGo > 0 ? std::min(limits.movesToGo, 40) : 30;
+    optimum = std::min(available, available / movesToGo + limits.increment * 3 / 4);
+    maximum = std::min(available * (movesToGo == 1 ? 9 : 4) / 10 + limits.increment, available);
+    maximum = std::max(optimum, std::min(maximum, optimum * 5));
+}
+
+int64_t TimeManager::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Each iteration usually takes a few times as long as the one before, so past half the budget
+// the next one would most likely be cut off and wasted.
+bool TimeManager::canStartIteration() const {
+    return !limited || elapsed() < optimum / 2;
+}
+
+bool TimeManager::outOfTime() const {
+    return limited && elapsed() >= maximum;
+}
@@ -0,0 +1,44 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <chrono>
+#include <cstdint>
+
+// What the caller allows the search to spend. Times are in milliseconds and -1 means "not set".
+struct SearchLimits {
+    int depth = 0;              // 0 = no depth limit
+    uint64_t nodes = 0;         // 0 = no node limit
+    int64_t moveTime = -1;      // Exact time for this move
+    int64_t timeLeft = -1;      // Clock of the side to move
+    int64_t increment = 0;
+    int movesToGo = 0;          // 0 = sudden death
+    bool infinite = false;      // Search until stopped
+};
+
+// Splits the clock into a soft budget, checked between iterations, and a hard budget the
+// search must never run past.
+class TimeManager {
+public:
+    TimeManager();
+
+    void start(const SearchLimits& limits);
+    int64_t elapsed() const;
+
+    // Whether another iteration is likely to finish inside the soft budget
+    bool canStartIteration() const;
+    bool outOfTime() const;
+
+    int64_t optimumTime() const { return optimum; }
+    int64_t maximumTime() const { return maximum; }
+
+private:
+    // Time lost to the GUI and the OS between its clock and ours
+    static constexpr int64_t MOVE_OVERHEAD = 30;
+
+    std::chrono::steady_clock::time_point startTime;
+    int64_t optimum;
+    int64_t maximum;
+    bool limited;
+};
+
+#endif
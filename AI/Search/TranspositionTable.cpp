@@ -0,0 +1,125 @@
+#include "TranspositionTable.h"
+#include "Search.h"
+#include <algorithm>
+#include <limits>
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    buckets = std::vector<Bucket>(count);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (Bucket& bucket : buckets) {
+        for (Slot& slot : bucket.slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & ((1 << GENERATION_BITS) - 1);
+}
+
+uint64_t TranspositionTable::pack(Move move, int score, int depth, Bound bound, int entryGeneration) {
+    return static_cast<uint64_t>(move.raw()) |
+        (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16) |
+        (static_cast<uint64_t>(depth & 0xFF) << 32) |
+        (static_cast<uint64_t>(bound) << 40) |
+        (static_cast<uint64_t>(entryGeneration) << 42);
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+    TTEntry entry;
+    entry.move = Move::fromRaw(static_cast<uint16_t>(data));
+    entry.score = static_cast<int16_t>(data >> 16);
+    entry.depth = depthOf(data);
+    entry.bound = static_cast<Bound>((data >> 40) & 3);
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = bucketFor(key);
+    for (const Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((keyXorData ^ data) == key && data != 0) {
+            entry = unpack(data);
+            return entry.bound != Bound::None;
+        }
+    }
+    return false;
+}
+
+// Overwrites the entry for this key if there is one. Otherwise the victim is the slot that is
+// shallowest once age is counted against it, so old searches make room for the current one.
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound) {
+    Bucket& bucket = bucketFor(key);
+    Slot* victim = &bucket.slots[0];
+    int victimWorth = std::numeric_limits<int>::max();
+
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+
+        if ((keyXorData ^ data) == key) {
+            TTEntry old = unpack(data);
+            // Keep the deeper result from this search unless the new one is exact
+            if (bound != Bound::Exact && generationOf(data) == generation && old.depth > depth + 2) {
+                return;
+            }
+            if (move.isNone()) {
+                move = old.move;
+            }
+            victim = &slot;
+            break;
+        }
+
+        int age = (generation - generationOf(data)) & ((1 << GENERATION_BITS) - 1);
+        int worth = data == 0 ? -1000 : depthOf(data) - 8 * age;
+        if (worth < victimWorth) {
+            victimWorth = worth;
+            victim = &slot;
+        }
+    }
+
+    uint64_t data = pack(move, score, depth, bound, generation);
+    victim->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = std::min<size_t>(buckets.size(), 1000 / BUCKET_SIZE);
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (const Slot& slot : buckets[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data != 0 && generationOf(data) == generation) {
+                used++;
+            }
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * BUCKET_SIZE));
+}
+
+int ScoreToTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
+
+int ScoreFromTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
@@ -0,0 +1,78 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "../../src/include/CommonComponents.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class Bound : uint8_t {
+    None = 0,
+    Upper = 1,      // Failed low: the score is at most this
+    Lower = 2,      // Failed high: the score is at least this
+    Exact = 3
+};
+
+struct TTEntry {
+    Move move = Move::none();
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+};
+
+// Shared hash of search results keyed on the Zobrist key. Buckets are one cache line of four
+// entries, so a probe costs a single memory fetch.
+//
+// Threads read and write without locks. Each entry is two 64-bit words, the packed data and
+// key ^ data. A torn write leaves a pair that no longer XORs back to the key, so it reads as a miss.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    // Rounds down to a power-of-two number of buckets
+    void resize(size_t megabytes);
+    void clear();
+
+    // Called once per search so entries from earlier searches age out first
+    void newSearch();
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+    // Fraction of entries written by the current search, in per mille as UCI's hashfull
+    int hashfull() const;
+    size_t sizeInBytes() const { return buckets.size() * sizeof(Bucket); }
+
+private:
+    static const int BUCKET_SIZE = 4;
+    static const int GENERATION_BITS = 6;
+
+    struct Slot {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    // data layout: move 16 | score 16 | depth 8 | bound 2 | generation 6
+    static uint64_t pack(Move move, int score, int depth, Bound bound, int generation);
+    static TTEntry unpack(uint64_t data);
+    static int generationOf(uint64_t data) { return static_cast<int>(data >> 42) & ((1 << GENERATION_BITS) - 1); }
+    static int depthOf(uint64_t data) { return static_cast<int>((data >> 32) & 0xFF); }
+
+    Bucket& bucketFor(uint64_t key) { return buckets[key & (buckets.size() - 1)]; }
+    const Bucket& bucketFor(uint64_t key) const { return buckets[key & (buckets.size() - 1)]; }
+
+    std::vector<Bucket> buckets;
+    uint8_t generation;
+};
+
+// Mate scores are stored relative to the node rather than the root, so a mate found through a
+// transposition keeps the right distance wherever it is probed from
+int ScoreToTT(int score, int ply);
+int ScoreFromTT(int score, int ply);
+
+#endif
@@ -2,91 +2,140 @@
 #include "include/CommonComponents.h"
 
 namespace BitboardOps {
-
-    Bitboard northOne(Bitboard b) {
-        Bitboard result;
-        result.board = b.board << 8;
-        return result;
-    }
-
-    Bitboard southOne(Bitboard b) {
-        Bitboard result;
-        result.board = b.board >> 8;
-        return result;
-    }
-
-    Bitboard eastOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board << 1) & NOT_A_FILE.board;
-        return result;
-    }
-
-    Bitboard westOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board >> 1) & NOT_H_FILE.board;
-        return result;
-    }
-
-    Bitboard northEastOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board << 9) & NOT_A_FILE.board;
-        return result;
-    }
-
-    Bitboard northWestOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board << 7) & NOT_H_FILE.board;
-        return result;
+    // Magic bitboards for sliding pieces. Each square gets a slice of one shared table, found by
+    // masking the occupancy down to the squares that can block, multiplying by a magic number and
+    // keeping the top bits. See https://www.chessprogramming.org/Magic_Bitboards
+
+    Magic RookMagics[64];
+    Magic BishopMagics[64];
+    Bitboard BetweenSquares[64][64];
+    Bitboard LineThrough[64][64];
+
+    namespace {
+        // 102400 and 5248 are the exact sums of 2^(relevant bits) over all 64 squares
+        Bitboard::BitboardType rookTable[102400];
+        Bitboard::BitboardType bishopTable[5248];
+
+        const int rookDirections[4][2] = { {-1, 0}, {1, 0}, {0, 1}, {0, -1} };
+        const int bishopDirections[4][2] = { {-1, 1}, {-1, -1}, {1, 1}, {1, -1} };
+
+        // Walks each ray one square at a time. Only used while building the tables.
+        Bitboard::BitboardType slidingAttacks(int square, Bitboard::BitboardType occupancy, const int directions[4][2]) {
+            Bitboard::BitboardType attacks = 0;
+            for (int d = 0; d < 4; d++) {
+                int row = square / 8 + directions[d][0];
+                int col = square % 8 + directions[d][1];
+                while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                    Bitboard::BitboardType bit = 1ULL << (row * 8 + col);
+                    attacks |= bit;
+                    if (occupancy & bit) {
+                        break;
+                    }
+                    row += directions[d][0];
+                    col += directions[d][1];
+                }
+            }
+            return attacks;
+        }
+
+        // Squares on the board edge never block anything further along the ray, so leave them out
+        Bitboard::BitboardType relevantMask(int square, const int directions[4][2]) {
+            const Bitboard::BitboardType rank1 = 0xFF00000000000000ULL, rank8 = 0x00000000000000FFULL;
+            const Bitboard::BitboardType fileA = 0x0101010101010101ULL, fileH = 0x8080808080808080ULL;
+            int row = square / 8;
+            int col = square % 8;
+            Bitboard::BitboardType edges = ((rank1 | rank8) & ~(row == 0 ? rank8 : row == 7 ? rank1 : 0ULL)) |
+                ((fileA | fileH) & ~(col == 0 ? fileA : col == 7 ? fileH : 0ULL));
+            return slidingAttacks(square, 0, directions) & ~edges;
+        }
+
+        // Magic numbers for this board layout (A8 = 0), found offline with a sparse random search.
+        // Fixing them here keeps startup instant and the tables identical on every run.
+        const Bitboard::BitboardType rookMagicNumbers[64] = {
+            0x1080004008801020ULL, 0x0840092002c03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+            0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+            0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+            0x000a001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+            0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021d00100ULL,
+            0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000a0001768104ULL,
+            0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+            0x0442000a00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040a00128541ULL,
+            0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+            0x0400802402800800ULL, 0xc100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+            0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000a0020ULL,
+            0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+            0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040a00300ULL, 0x0801100280080480ULL,
+            0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+            0x0000209300488001ULL, 0x04c1002414824001ULL, 0x020020000b001041ULL, 0x7000100004200901ULL,
+            0x8002002004100802ULL, 0x30010002084c0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL
+        };
+
+        const Bitboard::BitboardType bishopMagicNumbers[64] = {
+            0xa010041108003100ULL, 0x006082020a002900ULL, 0x6810010619200000ULL, 0x08281a0520000408ULL,
+            0x0001104001000400ULL, 0x0018901008048400ULL, 0x00040a0210245280ULL, 0x000200210808a402ULL,
+            0x9140048410821200ULL, 0x0800091010820041ULL, 0x20504804832202c0ULL, 0x0100091401081000ULL,
+            0x8021011140000012ULL, 0x0810020804450400ULL, 0x208b0542109008a2ULL, 0x0080084a08040204ULL,
+            0x0040e2a80811244cULL, 0x2505022008008108ULL, 0x0430220100420040ULL, 0x010a040420220040ULL,
+            0x1105000290400000ULL, 0x0093001200822120ULL, 0x4000a62048043004ULL, 0x280120048a015004ULL,
+            0x006090002a020814ULL, 0x44042000240800d0ULL, 0x01102800040a4400ULL, 0x1004080080220040ULL,
+            0x0001001011004024ULL, 0x0010044000805040ULL, 0x0914041200820100ULL, 0x0004821012821480ULL,
+            0x0024040500c05021ULL, 0x0088611002080200ULL, 0x0116080a00040020ULL, 0x4000020080080080ULL,
+            0x2450450140840040ULL, 0x0000880201484100ULL, 0x0222020404020092ULL, 0x8081110600002e00ULL,
+            0x2842101105000801ULL, 0x1100809008001025ULL, 0x00020202221c0400ULL, 0x0422014022009020ULL,
+            0x0210046102100c00ULL, 0xc004008082029102ULL, 0x00aa461801101200ULL, 0x0404080080201108ULL,
+            0x020542108c205002ULL, 0x0410544804100100ULL, 0x0040910841100000ULL, 0x0400200042021100ULL,
+            0x00004204850400c0ULL, 0x0200100410a42102ULL, 0x1040020801210102ULL, 0x0805040410420000ULL,
+            0x2884804130100200ULL, 0x800c262201242000ULL, 0x1058000194108800ULL, 0x0014221054420204ULL,
+            0x0104000012a02200ULL, 0x0200881003300100ULL, 0x0140400202840100ULL, 0x0402020801010201ULL
+        };
+
+        void initMagics(Magic magics[64], Bitboard::BitboardType* table, const Bitboard::BitboardType magicNumbers[64],
+            const int directions[4][2]) {
+            Bitboard::BitboardType* next = table;
+
+            for (int square = 0; square < 64; square++) {
+                Magic& m = magics[square];
+                m.mask = relevantMask(square, directions);
+                m.magic = magicNumbers[square];
+                m.shift = 64 - Bitboard(m.mask).count();
+                m.attacks = next;
+
+                // Enumerate every subset of the mask (Carry-Rippler trick) and store its attack set
+                int size = 0;
+                Bitboard::BitboardType subset = 0;
+                do {
+                    m.attacks[m.index(subset)] = slidingAttacks(square, subset, directions);
+                    size++;
+                    subset = (subset - m.mask) & m.mask;
+                } while (subset);
+
+                next += size;
+            }
+        }
     }
 
-    Bitboard southEastOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board >> 7) & NOT_A_FILE.board;
-        return result;
-    }
-
-    Bitboard southWestOne(Bitboard b) {
-        Bitboard result;
-        result.board = (b.board >> 9) & NOT_H_FILE.board;
-        return result;
-    }
-
-    Bitboard getLSB(Bitboard b) {
-        Bitboard result;
-        result.board = b.board & (~b.board + 1);
-        return result;
-    }
-
-    Bitboard popLSB(Bitboard& b) {
-        // Return LSB
-        Bitboard result;
-        result.board = b.board & (~b.board + 1);
-
-        // Also get rid of it from the input
-        b.board ^= result.board;
-        return result;
-    }
-    // Method using de Bruijn sequence. Very efficient. Not my own code but super fascinating and works well
-    // Can be found here: https://www.chessprogramming.org/BitScan#DeBruijnMultiplation
-    // Referencing for my own sake
-
-    const int index64[64] = {
-    0,  1, 48,  2, 57, 49, 28,  3,
-   61, 58, 50, 42, 38, 29, 17,  4,
-   62, 55, 59, 36, 53, 51, 43, 22,
-   45, 39, 33, 30, 24, 18, 12,  5,
-   63, 47, 56, 27, 60, 41, 37, 16,
-   54, 35, 52, 21, 44, 32, 23, 11,
-   46, 26, 40, 15, 34, 20, 31, 10,
-   25, 14, 19,  9, 13,  8,  7,  6
-    };
-
-    int bitScanForward(Bitboard b) {
-        const uint64_t debruijn64 = 0x03f79d71b4cb0a89ULL;
-        if (b.board == 0) return -1;  // Special case for empty bitboard
-
-        // Isolate LSB. The rest of this cannot be explained with inline comments
-        return index64[((b.board & (~b.board + 1)) * debruijn64) >> 58];
+    void initSlidingAttacks() {
+        static bool initialized = false;
+        if (initialized) {
+            return;
+        }
+        initMagics(RookMagics, rookTable, rookMagicNumbers, rookDirections);
+        initMagics(BishopMagics, bishopTable, bishopMagicNumbers, bishopDirections);
+
+        for (int from = 0; from < 64; from++) {
+            for (int to = 0; to < 64; to++) {
+                Bitboard ends = Bitboard::fromSquare(from) | Bitboard::fromSquare(to);
+                if (bishopAttacks(from, Bitboard()).isOccupied(to)) {
+                    BetweenSquares[from][to] = bishopAttacks(from, Bitboard::fromSquare(to)) & bishopAttacks(to, Bitboard::fromSquare(from));
+                    LineThrough[from][to] = (bishopAttacks(from, Bitboard()) & bishopAttacks(to, Bitboard())) | ends;
+                }
+                else if (rookAttacks(from, Bitboard()).isOccupied(to)) {
+                    BetweenSquares[from][to] = rookAttacks(from, Bitboard::fromSquare(to)) & rookAttacks(to, Bitboard::fromSquare(from));
+                    LineThrough[from][to] = (rookAttacks(from, Bitboard()) & rookAttacks(to, Bitboard())) | ends;
+                }
+            }
+        }
+        initialized = true;
     }
 
 }
\ No newline at end of file
@@ -1,244 +1,319 @@
 #include "include/Game.h"
-#include "include/GameState.h"
+#include "include/ZobristHash.h"
+#include "include/BitboardOps.h"
+#include "include/PieceSquareTables.h"
 #include "include/CommonComponents.h"
+#include <algorithm>
 #include <limits>
 #include <unordered_map>
 #include <iostream>
+#include <cstdlib>
+#include <cctype>
+#include <sstream>
 
 Game::Game() : m_pieceManager() {
-    // ChessBoard initialization is now handled by GameState
+    // Game holds no position of its own; every rule takes the Position it works on
 }
 
-std::vector<Move> Game::GenerateLegalMoves(int currentPiece, int indexOnBoard) const {
-    auto& gameState = GameState::getInstance();
-    if (!IsCorrectMove(currentPiece)) {
-        return {};  // Return an empty vector
+// Sets up the whole game state from a FEN string: pieces, side to move, castling rights,
+// en passant target and move clocks. Returns false if the piece placement can't be read, or
+// doesn't have one king a side and at most 32 pieces.
+bool Game::LoadFEN(Position& position, const std::string& fen) {
+    std::unordered_map<char, int> fenToPiece = {
+        {'p', Piece::BlackPawn}, {'n', Piece::BlackKnight}, {'b', Piece::BlackBishop},
+        {'r', Piece::BlackRook}, {'q', Piece::BlackQueen}, {'k', Piece::BlackKing},
+        {'P', Piece::WhitePawn}, {'N', Piece::WhiteKnight}, {'B', Piece::WhiteBishop},
+        {'R', Piece::WhiteRook}, {'Q', Piece::WhiteQueen}, {'K', Piece::WhiteKing}
+    };
+
+    std::istringstream fields(fen);
+    std::string placement, side = "w", castling = "-", enPassant = "-";
+    int halfMoveClock = 0, fullMoveNumber = 1;
+    fields >> placement >> side >> castling >> enPassant >> halfMoveClock >> fullMoveNumber;
+
+    position.board.fill(Piece::None);
+    PieceManager::ClearAllBitboards(position);
+    position.kingSquares[0] = position.kingSquares[1] = -1;
+    position.middlegame = position.endgame = position.phase = 0;
+    int index = 0;
+    for (char c : placement) {
+        if (isdigit(c)) {
+            index += c - '0';
+        } else if (c != '/') {
+            auto it = fenToPiece.find(c);
+            if (it == fenToPiece.end() || index >= TOTAL_SQUARES) {
+                return false;
+            }
+            PutPiece(position, it->second, index++);
+        }
     }
-    std::vector<Move> allMoves;
 
-    switch (currentPiece & 7) {  // Use bitwise AND with 7 to get just the piece type
-    case Piece::Rook:
-    case Piece::Queen:
-    case Piece::Bishop:
-    {
-        allMoves = m_pieceManager.GenerateSlidingMoves(indexOnBoard, currentPiece);
-        break;
+    // The move generator needs exactly one king a side, and nothing downstream (the network's
+    // inputs, for one) is sized for more than the 32 pieces a game can have
+    if (position.bitboards.WhiteKing.count() != 1 || position.bitboards.BlackKing.count() != 1 ||
+        position.occupancy().count() > 32) {
+        return false;
     }
-    case Piece::Knight:
-    {
-        allMoves = m_pieceManager.GenerateKnightMoves(indexOnBoard, currentPiece);
-        break;
+
+    // moveCount is odd whenever it's white's turn
+    position.moveCount = 2 * (std::max(fullMoveNumber, 1) - 1) + (side == "b" ? 2 : 1);
+
+    GameRuleFlags flags;
+    flags.h1RookHasMoved = castling.find('K') == std::string::npos;
+    flags.a1RookHasMoved = castling.find('Q') == std::string::npos;
+    flags.h8RookHasMoved = castling.find('k') == std::string::npos;
+    flags.a8RookHasMoved = castling.find('q') == std::string::npos;
+    flags.whiteKingHasMoved = flags.h1RookHasMoved && flags.a1RookHasMoved;
+    flags.blackKingHasMoved = flags.h8RookHasMoved && flags.a8RookHasMoved;
+    if (enPassant.size() == 2) {
+        flags.enPassantTargetSquare = SquareFromName(enPassant);
     }
-    case Piece::Pawn:
-    {
-        allMoves = m_pieceManager.GeneratePawnMoves(indexOnBoard, currentPiece);
-        break;
+    flags.halfMoveClock = halfMoveClock;
+    position.gameFlags = flags;
+    position.key = ZobristHash::hash(position.board, !IsWhiteMove(position), flags);
+    position.pawnKey = ZobristHash::pawnHash(position.board);
+
+    position.undoStack.clear();
+    position.positionHistory.clear();
+    position.positionHistory.push_back(position.key);
+    return true;
+}
+
+// Squares as algebraic names, e.g. A8 = 0 is "a8"
+std::string Game::SquareName(int square) {
+    return { static_cast<char>('a' + square % 8), static_cast<char>('8' - square / 8) };
+}
+
+int Game::SquareFromName(const std::string& name) {
+    if (name.size() < 2 || name[0] < 'a' || name[0] > 'h' || name[1] < '1' || name[1] > '8') {
+        return -1;
     }
-    case Piece::King:
-    {
-        allMoves = m_pieceManager.GenerateKingMoves(indexOnBoard, currentPiece, *this);
-        break;
+    return (name[0] - 'a') + ('8' - name[1]) * 8;
+}
+
+// Long algebraic notation as UCI uses it, e.g. "e2e4" or "e7e8q"
+std::string Game::MoveToString(Move move) {
+    std::string text = SquareName(move.startSquare()) + SquareName(move.targetSquare());
+    if (move.isPromotion()) {
+        text += " nbrq"[move.promotionType() - Piece::Pawn];
     }
-    default:
-        std::cerr << "Unexpected piece type: " << currentPiece << std::endl;
-        return {};
+    return text;
+}
+
+// The legal move written as text, or Move::none() if there isn't one
+Move Game::MoveFromString(const Position& position, const std::string& text) const {
+    MoveList moves;
+    GenerateMoves(position, moves);
+    for (Move move : moves) {
+        if (MoveToString(move) == text) {
+            return move;
+        }
     }
-    return FilterLegalMoves(allMoves, currentPiece);
+    return Move::none();
 }
 
-std::vector<Move> Game::FilterLegalMoves(const std::vector<Move>& moves, int currentPlayer) const {
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> legalMoves;
-    for (const auto& move : moves) {
-        BoardState tempBoard = gameState.board;
-        GameRuleFlags tempFlags = gameState.gameFlags;
-        int tempMoveCount = gameState.moveCount;
+void Game::GenerateMoves(const Position& position, MoveList& moves, MoveGenType type) const {
+    moves.clear();
+    m_pieceManager.GenerateMoves(position, IsWhiteMove(position) ? Piece::White : Piece::Black, moves, type);
+}
 
-        Move moveCopy = move;  // Create a non-const copy
-        const_cast<Game*>(this)->MakeMove(moveCopy, currentPlayer);
+// Checks the move against the board piece by piece, then plays it to see that our king is safe.
+// Much cheaper than generating every move when only a handful of candidates need checking.
+bool Game::IsLegal(Position& position, Move move) {
+    if (move.isNone() || (!move.isPromotion() && move.promotionType() != Piece::Knight)) {
+        return false;  // Only the generator's own encoding of a move can match it
+    }
 
-        int currentColor = currentPlayer & 0b11000;
-        if (!IsKingInCheck(currentColor)) {
-            legalMoves.push_back(move);
+    int color = IsWhiteMove(position) ? Piece::White : Piece::Black;
+    bool isWhite = color == Piece::White;
+    int from = move.startSquare();
+    int to = move.targetSquare();
+    int piece = position.board[from];
+    if (piece == Piece::None || (piece & 0b11000) != color) {
+        return false;
+    }
+
+    Bitboard us = position.colorOccupancy(isWhite);
+    Bitboard them = position.colorOccupancy(!isWhite);
+    Bitboard occupancy = us | them;
+    if (us.isOccupied(to)) {
+        return false;
+    }
+
+    int pieceType = piece & 7;
+    if (move.isCastling()) {
+        bool kingSide = to > from;
+        return pieceType == Piece::King && to == from + (kingSide ? 2 : -2) && !IsKingInCheck(position, color) &&
+            m_pieceManager.CanCastle(position, piece, kingSide, occupancy);
+    }
+
+    if (pieceType == Piece::Pawn) {
+        int direction = isWhite ? -8 : 8;
+        bool attacksTarget = BitboardOps::PawnAttacks[isWhite ? 0 : 1][from].isOccupied(to);
+        if (move.isEnPassant()) {
+            if (to != position.gameFlags.enPassantTargetSquare || !attacksTarget) {
+                return false;
+            }
+        }
+        else {
+            bool push = to == from + direction && position.board[to] == Piece::None;
+            bool doublePush = to == from + 2 * direction && from / 8 == (isWhite ? 6 : 1) &&
+                position.board[from + direction] == Piece::None && position.board[to] == Piece::None;
+            bool capture = attacksTarget && them.isOccupied(to);
+            if (move.isPromotion() != (to / 8 == (isWhite ? 0 : 7)) || !(push || doublePush || capture)) {
+                return false;
+            }
+        }
+    }
+    else {
+        Bitboard attacks;
+        switch (pieceType) {
+        case Piece::Knight: attacks = BitboardOps::KnightAttacks[from]; break;
+        case Piece::Bishop: attacks = BitboardOps::bishopAttacks(from, occupancy); break;
+        case Piece::Rook: attacks = BitboardOps::rookAttacks(from, occupancy); break;
+        case Piece::Queen: attacks = BitboardOps::queenAttacks(from, occupancy); break;
+        case Piece::King: attacks = BitboardOps::KingAttacks[from]; break;
+        }
+        if (move.type() != Move::Normal || !attacks.isOccupied(to)) {
+            return false;
         }
+    }
+
+    MakeMove(position, move);
+    bool legal = !IsKingInCheck(position, color);
+    UnmakeMove(position, move);
+    return legal;
+}
+
+// Legal moves for the piece on one square. Used by the GUI when a piece is picked up.
+std::vector<Move> Game::GenerateLegalMoves(const Position& position, int currentPiece, int indexOnBoard) const {
+    if (!IsCorrectMove(position, currentPiece)) {
+        return {};  // Return an empty vector
+    }
+
+    MoveList allMoves;
+    GenerateMoves(position, allMoves);
 
-        // Restore the original game state
-        gameState.board = tempBoard;
-        gameState.gameFlags = tempFlags;
-        gameState.moveCount = tempMoveCount;
+    std::vector<Move> pieceMoves;
+    for (const auto& move : allMoves) {
+        if (move.startSquare() == indexOnBoard) {
+            pieceMoves.push_back(move);
+        }
     }
-    return legalMoves;
+    return pieceMoves;
 }
 
 bool Game::IsPieceWhite(int pieceType) const {
     return (pieceType & Piece::White) != 0;
 }
 
-bool Game::IsWhiteMove() const {
-    return GameState::getInstance().moveCount % 2 != 0;
+bool Game::IsWhiteMove(const Position& position) const {
+    return position.moveCount % 2 != 0;
 }
 
-bool Game::IsCorrectMove(int pieceType) const {
-    return IsPieceWhite(pieceType) == IsWhiteMove();
+bool Game::IsCorrectMove(const Position& position, int pieceType) const {
+    return IsPieceWhite(pieceType) == IsWhiteMove(position);
 }
 
-bool Game::IsSquareAttackedSimple(int square, int attackingColor) const {
-    auto& gameState = GameState::getInstance();
-    // Check for pawn attacks
-    int pawnDirection = (attackingColor == Piece::White) ? -1 : 1;
-    int pawnAttackLeft = square + pawnDirection * 7;
-    int pawnAttackRight = square + pawnDirection * 9;
-    if (pawnAttackLeft >= 0 && pawnAttackLeft < 64 && gameState.board[pawnAttackLeft] == (Piece::Pawn | attackingColor)) return true;
-    if (pawnAttackRight >= 0 && pawnAttackRight < 64 && gameState.board[pawnAttackRight] == (Piece::Pawn | attackingColor)) return true;
-
-    // Check for knight attacks
-    int knightMoves[] = { -17, -15, -10, -6, 6, 10, 15, 17 };
-    for (int move : knightMoves) {
-        int targetSquare = square + move;
-        if (targetSquare >= 0 && targetSquare < 64 && gameState.board[targetSquare] == (Piece::Knight | attackingColor)) return true;
-    }
-
-    // Check for king attacks (for adjacent squares)
-    int kingMoves[] = { -9, -8, -7, -1, 1, 7, 8, 9 };
-    for (int move : kingMoves) {
-        int targetSquare = square + move;
-        if (targetSquare >= 0 && targetSquare < 64 && gameState.board[targetSquare] == (Piece::King | attackingColor)) return true;
-    }
-
-    // Check for sliding piece attacks (rook, bishop, queen)
-    int slidingDirections[] = { -8, 8, -1, 1, -9, 9, -7, 7 };
-    for (int direction : slidingDirections) {
-        int targetSquare = square + direction;
-        while (targetSquare >= 0 && targetSquare < 64) {
-            int piece = gameState.board[targetSquare];
-            if (piece != Piece::None) {
-                if ((piece & attackingColor) &&
-                    (piece == (Piece::Queen | attackingColor) ||
-                        (abs(direction) == 8 || abs(direction) == 1) && piece == (Piece::Rook | attackingColor) ||
-                        (abs(direction) == 7 || abs(direction) == 9) && piece == (Piece::Bishop | attackingColor))) {
-                    return true;
-                }
-                break;
-            }
-            targetSquare += direction;
-        }
-    }
-
-    return false;
-}
-
-bool Game::IsKingInCheck(int kingColor) const {
-    auto& gameState = GameState::getInstance();
-    int kingLocation = m_pieceManager.FindKingLocation(kingColor);
+bool Game::IsKingInCheck(const Position& position, int kingColor) const {
+    int kingLocation = position.kingSquare(kingColor);
     if (kingLocation == -1) {
         std::cerr << "Error: King not found on the board" << std::endl;
         return false;
     }
 
-    int oppositeColor = (kingColor == Piece::White) ? Piece::Black : Piece::White;
-    return IsSquareAttackedSimple(kingLocation, oppositeColor);
+    bool enemyIsWhite = kingColor != Piece::White;
+    return !(position.attackersTo(kingLocation, position.occupancy()) & position.colorOccupancy(enemyIsWhite)).empty();
 }
 
-bool Game::BlackCheckmate() const {
-    auto& gameState = GameState::getInstance();
-    for (int i = 0; i < TOTAL_SQUARES; ++i) {
-        if (gameState.board[i] & Piece::Black) {
-            std::vector<Move> possibleMoves = GenerateLegalMoves(gameState.board[i], i);
-            if (!possibleMoves.empty()) {
-                return false;
-            }
-        }
+bool Game::BlackCheckmate(const Position& position) const {
+    if (IsWhiteMove(position)) {
+        return false;
     }
-    if (IsKingInCheck(Piece::Black)) {
+    MoveList moves;
+    GenerateMoves(position, moves);
+    if (moves.empty() && IsKingInCheck(position, Piece::Black)) {
         std::cout << "Black is checkmated. White wins!" << std::endl;
         return true;
     }
     return false;
 }
 
-bool Game::WhiteCheckmate() const {
-    auto& gameState = GameState::getInstance();
-    for (int i = 0; i < TOTAL_SQUARES; ++i) {
-        if (gameState.board[i] & Piece::White) {
-            std::vector<Move> possibleMoves = GenerateLegalMoves(gameState.board[i], i);
-            if (!possibleMoves.empty()) {
-                return false;
-            }
-        }
+bool Game::WhiteCheckmate(const Position& position) const {
+    if (!IsWhiteMove(position)) {
+        return false;
     }
-    if (IsKingInCheck(Piece::White)) {
+    MoveList moves;
+    GenerateMoves(position, moves);
+    if (moves.empty() && IsKingInCheck(position, Piece::White)) {
         std::cout << "White is checkmated. Black wins!" << std::endl;
         return true;
     }
     return false;
 }
 
-bool Game::GameDrawStaleMate() const{
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> possibleMoves;
-    for (int i = 0; i < TOTAL_SQUARES; ++i) {
-        if (gameState.board[i] != Piece::None) {
-            std::vector<Move> pieceMoves = GenerateLegalMoves(gameState.board[i], i);
-            possibleMoves.insert(possibleMoves.end(), pieceMoves.begin(), pieceMoves.end());
-        }
-    }
-    if (possibleMoves.empty() && (!IsKingInCheck(Piece::White) && !IsKingInCheck(Piece::Black))) {
+bool Game::GameDrawStaleMate(const Position& position) const{
+    MoveList moves;
+    GenerateMoves(position, moves);
+    int currentColor = IsWhiteMove(position) ? Piece::White : Piece::Black;
+    if (moves.empty() && !IsKingInCheck(position, currentColor)) {
         std::cout << "The game is a draw by stalemate" << std::endl;
         return true;
     }
     return false;
 }
 
-bool Game::GameDrawFiftyMove() const{
-    return GameState::getInstance().gameFlags.halfMoveClock >= 100;  // 50 full moves = 100 half-moves
+bool Game::GameDrawFiftyMove(const Position& position) const{
+    return position.gameFlags.halfMoveClock >= 100;  // 50 full moves = 100 half-moves
 }
 
-bool Game::GameDrawThreefold() const {
-    auto& gameState = GameState::getInstance();
-    if (gameState.positionHistory.size() < 5) return false; // Need at least 5 moves for a threefold repetition
-
-    std::unordered_map<uint64_t, int> positionCounts;
+bool Game::GameDrawThreefold(const Position& position) const {
+    return position.repetitionCount() >= 3;
+}
 
-    for (const auto& hash : gameState.positionHistory) {
-        positionCounts[hash]++;
-        if (positionCounts[hash] >= 3) {
-            return true;
+GameResult Game::GetResult(const Position& position, const MoveList& legalMoves) const {
+    bool whiteToMove = IsWhiteMove(position);
+    if (legalMoves.empty()) {
+        if (!IsKingInCheck(position, whiteToMove ? Piece::White : Piece::Black)) {
+            return GameResult::Draw;
         }
+        return whiteToMove ? GameResult::BlackWins : GameResult::WhiteWins;
     }
-
-    return false;
+    if (GameDrawFiftyMove(position) || GameDrawInsufficientMaterial(position) || GameDrawThreefold(position)) {
+        return GameResult::Draw;
+    }
+    return GameResult::Ongoing;
 }
 
-bool Game::GameDrawInsufficientMaterial() const {
-    auto& gameState = GameState::getInstance();
+bool Game::GameDrawInsufficientMaterial(const Position& position) const {
     // Combine all pieces except kings into a single bitboard
     Bitboard::BitboardType allPieces =
-        gameState.bitboards.WhitePawns.board | gameState.bitboards.WhiteKnights.board |
-        gameState.bitboards.WhiteBishops.board | gameState.bitboards.WhiteRooks.board |
-        gameState.bitboards.WhiteQueens.board |
-        gameState.bitboards.BlackPawns.board | gameState.bitboards.BlackKnights.board |
-        gameState.bitboards.BlackBishops.board | gameState.bitboards.BlackRooks.board |
-        gameState.bitboards.BlackQueens.board;
+        position.bitboards.WhitePawns.board | position.bitboards.WhiteKnights.board |
+        position.bitboards.WhiteBishops.board | position.bitboards.WhiteRooks.board |
+        position.bitboards.WhiteQueens.board |
+        position.bitboards.BlackPawns.board | position.bitboards.BlackKnights.board |
+        position.bitboards.BlackBishops.board | position.bitboards.BlackRooks.board |
+        position.bitboards.BlackQueens.board;
 
     // If no pieces left besides kings, it's a draw
     if (allPieces == 0) return true;
 
     // If more than 3 pieces, it's not insufficient material
-    if (__builtin_popcountll(allPieces) > 3) return false;
+    if (Bitboard(allPieces).count() > 3) return false;
 
     // Check for single minor piece (bishop or knight)
-    if (__builtin_popcountll(allPieces) == 1) {
-        return (allPieces & (gameState.bitboards.WhiteKnights.board | gameState.bitboards.BlackKnights.board |
-            gameState.bitboards.WhiteBishops.board | gameState.bitboards.BlackBishops.board)) != 0;
+    if (Bitboard(allPieces).count() == 1) {
+        return (allPieces & (position.bitboards.WhiteKnights.board | position.bitboards.BlackKnights.board |
+            position.bitboards.WhiteBishops.board | position.bitboards.BlackBishops.board)) != 0;
     }
 
     // Check for two knights
-    if (__builtin_popcountll(allPieces) == 2) {
-        return allPieces == gameState.bitboards.WhiteKnights.board || allPieces == gameState.bitboards.BlackKnights.board;
+    if (Bitboard(allPieces).count() == 2) {
+        return allPieces == position.bitboards.WhiteKnights.board || allPieces == position.bitboards.BlackKnights.board;
     }
 
     // Check for bishops
-    Bitboard::BitboardType bishopPieces = gameState.bitboards.WhiteBishops.board | gameState.bitboards.BlackBishops.board;
+    Bitboard::BitboardType bishopPieces = position.bitboards.WhiteBishops.board | position.bitboards.BlackBishops.board;
     if (allPieces == bishopPieces) {
         // Check if bishops are on the same color
         const Bitboard::BitboardType LIGHT_SQUARES = 0x55AA55AA55AA55AAULL;
@@ -249,39 +324,136 @@ bool Game::GameDrawInsufficientMaterial() const {
     return false;
 }
 
-void Game::MakeMove(Move& move, int currentPiece) {
-    auto& gameState = GameState::getInstance();
-    if (move.startSquare != move.targetSquare) {
-        bool isPawnMove = (currentPiece & 7) == Piece::Pawn;
-        bool isCapture = gameState.board[move.targetSquare] != Piece::None || move.isEnPassant;
+void Game::PutPiece(Position& position, int piece, int square) {
+    position.board[square] = piece;
+    position.bitboards.forPiece(piece).set(square);
+    position.key ^= ZobristHash::pieceKey(piece, square);
+    position.middlegame += PieceSquareTables::SCORES.middlegame[Piece::index(piece)][square];
+    position.endgame += PieceSquareTables::SCORES.endgame[Piece::index(piece)][square];
+    position.phase += PieceSquareTables::PHASE_WEIGHT[piece & 7];
+    if ((piece & 7) == Piece::King) {
+        position.kingSquares[(piece & Piece::White) ? 0 : 1] = square;
+    }
+    else if ((piece & 7) == Piece::Pawn) {
+        position.pawnKey ^= ZobristHash::pieceKey(piece, square);
+    }
+}
+
+void Game::RemovePiece(Position& position, int square) {
+    int piece = position.board[square];
+    position.bitboards.forPiece(piece).clear(square);
+    position.key ^= ZobristHash::pieceKey(piece, square);
+    position.middlegame -= PieceSquareTables::SCORES.middlegame[Piece::index(piece)][square];
+    position.endgame -= PieceSquareTables::SCORES.endgame[Piece::index(piece)][square];
+    position.phase -= PieceSquareTables::PHASE_WEIGHT[piece & 7];
+    if ((piece & 7) == Piece::Pawn) {
+        position.pawnKey ^= ZobristHash::pieceKey(piece, square);
+    }
+    position.board[square] = Piece::None;
+}
 
-        if (isPawnMove || isCapture) {
-            gameState.gameFlags.halfMoveClock = 0;
-        } else {
-            gameState.gameFlags.halfMoveClock++;
-        }
+// Plays the move, updating the board and bitboards for just the squares it touches.
+// Whatever can't be recomputed goes on the undo stack for UnmakeMove.
+void Game::MakeMove(Position& position, Move move) {
+    int startSquare = move.startSquare();
+    int targetSquare = move.targetSquare();
+    int currentPiece = position.board[startSquare];
+    int color = currentPiece & 0b11000;
+    bool isPawnMove = (currentPiece & 7) == Piece::Pawn;
+    int capturedSquare = move.isEnPassant() ? targetSquare + (color == Piece::White ? 8 : -8) : targetSquare;
+    int capturedPiece = position.board[capturedSquare];
+
+    position.undoStack.push_back({ capturedPiece, position.gameFlags, position.key });
+
+    // Take the old castling rights and en passant file out of the key; the new ones go back in below
+    position.key ^= ZobristHash::castlingKey(position.gameFlags.castlingRights())
+                 ^ ZobristHash::enPassantKey(position.gameFlags.enPassantTargetSquare);
+
+    if (isPawnMove || capturedPiece != Piece::None) {
+        position.gameFlags.halfMoveClock = 0;
+    } else {
+        position.gameFlags.halfMoveClock++;
+    }
 
-        gameState.board[move.startSquare] = Piece::None;
+    if (capturedPiece != Piece::None) {
+        RemovePiece(position, capturedSquare);
+    }
+    RemovePiece(position, startSquare);
+    PutPiece(position, move.isPromotion() ? (move.promotionType() | color) : currentPiece, targetSquare);
 
-        if (move.isPromotion) {
-            gameState.board[move.targetSquare] = (currentPiece & Piece::White) ? Piece::WhiteQueen : Piece::BlackQueen;
-            move.promotionPiece = (currentPiece & Piece::White) ? Piece::WhiteQueen : Piece::BlackQueen;
-        } else {
-            gameState.board[move.targetSquare] = currentPiece;
-        }
+    if (move.isCastling()) {
+        RemovePiece(position, move.rookStartSquare());
+        PutPiece(position, Piece::Rook | color, move.rookTargetSquare());
+    }
 
-        if (move.isEnPassant) {
-            int capturedPawnSquare = move.targetSquare + ((currentPiece & Piece::White) ? 8 : -8);
-            gameState.board[capturedPawnSquare] = Piece::None;
-        } else if (move.isCastling) {
-            gameState.board[move.rookStartSquare] = Piece::None;
-            gameState.board[move.rookTargetSquare] = (currentPiece & Piece::White) ? Piece::WhiteRook : Piece::BlackRook;
+    // A double pawn push leaves an en passant target behind; anything else clears it
+    bool isDoublePush = isPawnMove && abs(targetSquare - startSquare) == 16;
+    position.gameFlags.enPassantTargetSquare = isDoublePush ? (startSquare + targetSquare) / 2 : -1;
+
+    // Anything moving from or onto a king or rook home square costs that castling right
+    for (int square : { startSquare, targetSquare }) {
+        switch (square) {
+        case ChessSquares::E1: position.gameFlags.whiteKingHasMoved = true; break;
+        case ChessSquares::A1: position.gameFlags.a1RookHasMoved = true; break;
+        case ChessSquares::H1: position.gameFlags.h1RookHasMoved = true; break;
+        case ChessSquares::E8: position.gameFlags.blackKingHasMoved = true; break;
+        case ChessSquares::A8: position.gameFlags.a8RookHasMoved = true; break;
+        case ChessSquares::H8: position.gameFlags.h8RookHasMoved = true; break;
         }
+    }
 
-        m_pieceManager.UpdateBitboards(move, currentPiece);
-        gameState.moveCount++;
+    position.key ^= ZobristHash::castlingKey(position.gameFlags.castlingRights())
+                 ^ ZobristHash::enPassantKey(position.gameFlags.enPassantTargetSquare)
+                 ^ ZobristHash::sideKey();
+    position.moveCount++;
+    position.positionHistory.push_back(position.key);
+}
 
-        // This was previously in ChessBoard, consider if it's still needed and where it should be called
-        // UpdateChessPieces();
+// Reverses the last MakeMove. The move must be the same one that was just made.
+void Game::UnmakeMove(Position& position, Move move) {
+    UndoRecord undo = position.undoStack.back();
+    position.undoStack.pop_back();
+    position.positionHistory.pop_back();
+    position.moveCount--;
+
+    int startSquare = move.startSquare();
+    int targetSquare = move.targetSquare();
+    int color = position.board[targetSquare] & 0b11000;
+    int movedPiece = move.isPromotion() ? (Piece::Pawn | color) : position.board[targetSquare];
+
+    if (move.isCastling()) {
+        RemovePiece(position, move.rookTargetSquare());
+        PutPiece(position, Piece::Rook | color, move.rookStartSquare());
     }
-}
\ No newline at end of file
+
+    RemovePiece(position, targetSquare);
+    PutPiece(position, movedPiece, startSquare);
+
+    if (undo.capturedPiece != Piece::None) {
+        int capturedSquare = move.isEnPassant() ? targetSquare + (color == Piece::White ? 8 : -8) : targetSquare;
+        PutPiece(position, undo.capturedPiece, capturedSquare);
+    }
+
+    position.gameFlags = undo.previousFlags;
+    position.key = undo.previousKey;
+}
+
+// The halfmove clock restarts so repetition checks don't look back past the null move: a
+// position reached only by passing was never really played
+void Game::MakeNullMove(Position& position) {
+    position.undoStack.push_back({ Piece::None, position.gameFlags, position.key });
+    position.key ^= ZobristHash::enPassantKey(position.gameFlags.enPassantTargetSquare) ^ ZobristHash::sideKey();
+    position.gameFlags.enPassantTargetSquare = -1;
+    position.gameFlags.halfMoveClock = 0;
+    position.moveCount++;
+    position.positionHistory.push_back(position.key);
+}
+
+void Game::UnmakeNullMove(Position& position) {
+    UndoRecord undo = position.undoStack.back();
+    position.undoStack.pop_back();
+    position.positionHistory.pop_back();
+    position.moveCount--;
+    position.gameFlags = undo.previousFlags;
+    position.key = undo.previousKey;
+}
@@ -1,99 +1,107 @@
 #include "include/GameManager.h"
-#include "include/GameState.h"
 #include "include/CommonComponents.h"
 #include <iostream>
 
 GameManager::GameManager()
-    : m_dragOffset{ 0, 0 } {
+    : m_selectedPieceIndex(-1),
+      m_dragOffset{ 0, 0 } {
 }
 
 void GameManager::initialize() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Chess Engine with raylib");
-    m_board.InitializeBoard();
+    m_board.InitializeBoard(m_position);
     m_board.LoadPieceTextures();
 
     // Register the UpdateChessPieces as an observer
-    registerMoveObserver([this]() { m_board.UpdateChessPieces(); });
+    registerMoveObserver([this]() { m_board.UpdateChessPieces(m_position); });
 }
 
 void GameManager::processInput() {
-    auto& gameState = GameState::getInstance();
-
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         Vector2 mousePos = GetMousePosition();
         int col = (int)(mousePos.x / SQUARE_SIZE);
         int row = (int)(mousePos.y / SQUARE_SIZE);
         int index = row * BOARD_SIZE + col;
 
-        if (index >= 0 && index < TOTAL_SQUARES && gameState.board[index] != Piece::None) {
-            gameState.selectedPieceIndex = index;
+        if (index >= 0 && index < TOTAL_SQUARES && m_position.board[index] != Piece::None) {
+            m_selectedPieceIndex = index;
             m_dragOffset = { mousePos.x - (col * SQUARE_SIZE + SQUARE_SIZE / 2.0f),
                              mousePos.y - (row * SQUARE_SIZE + SQUARE_SIZE / 2.0f) };
-            m_currentLegalMoves = m_game.GenerateLegalMoves(gameState.board[gameState.selectedPieceIndex], gameState.selectedPieceIndex);
+            m_currentLegalMoves = m_game.GenerateLegalMoves(m_position, m_position.board[m_selectedPieceIndex], m_selectedPieceIndex);
         }
     }
 
-    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && gameState.selectedPieceIndex != -1) {
+    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && m_selectedPieceIndex != -1) {
         Vector2 mousePos = GetMousePosition();
         int newCol = Clamp((int)(mousePos.x / SQUARE_SIZE), 0, BOARD_SIZE - 1);
         int newRow = Clamp((int)(mousePos.y / SQUARE_SIZE), 0, BOARD_SIZE - 1);
         int newIndex = newRow * BOARD_SIZE + newCol;
 
+        // The four promotions share a target square, so the one the player picked has to match too
         bool isLegalMove = false;
-        Move selectedMove;
+        Move selectedMove = Move::none();
+        int promotionType = promotionChoice();
         for (const auto& move : m_currentLegalMoves) {
-            if (move.targetSquare == newIndex) {
+            if (move.targetSquare() == newIndex && (!move.isPromotion() || move.promotionType() == promotionType)) {
                 selectedMove = move;
                 isLegalMove = true;
                 break;
             }
         }
 
-        if (newIndex != gameState.selectedPieceIndex && isLegalMove) {
-            m_game.MakeMove(selectedMove, gameState.board[gameState.selectedPieceIndex]);
-            m_board.UpdateGameFlags(gameState.selectedPieceIndex);
-            uint64_t newHash = m_zobristHash.hash(gameState.board, gameState.moveCount % 2 == 0, gameState.gameFlags);
-            gameState.positionHistory.push_back(newHash);
+        if (newIndex != m_selectedPieceIndex && isLegalMove) {
+            m_game.MakeMove(m_position, selectedMove);
             
             // Notify observers after a move is made
             notifyMoveObservers();
         }
 
-        gameState.selectedPieceIndex = -1;
+        m_selectedPieceIndex = -1;
         m_currentLegalMoves.clear();
     }
 }
 
+int GameManager::promotionChoice() {
+    if (IsKeyDown(KEY_N)) {
+        return Piece::Knight;
+    }
+    if (IsKeyDown(KEY_B)) {
+        return Piece::Bishop;
+    }
+    if (IsKeyDown(KEY_R)) {
+        return Piece::Rook;
+    }
+    return Piece::Queen;
+}
+
 void GameManager::update() {
-    if (m_game.BlackCheckmate() || m_game.WhiteCheckmate() || m_game.GameDrawStaleMate() ||
-        m_game.GameDrawInsufficientMaterial() || m_game.GameDrawFiftyMove() || m_game.GameDrawThreefold()) {
+    if (m_game.BlackCheckmate(m_position) || m_game.WhiteCheckmate(m_position) || m_game.GameDrawStaleMate(m_position) ||
+        m_game.GameDrawInsufficientMaterial(m_position) || m_game.GameDrawFiftyMove(m_position) || m_game.GameDrawThreefold(m_position)) {
         // Handle game over conditions
     }
 }
 
 void GameManager::render() {
-    auto& gameState = GameState::getInstance();
-
     BeginDrawing();
     ClearBackground(RAYWHITE);
 
     m_board.DrawChessBoard();
 
-    if (gameState.selectedPieceIndex != -1) {
+    if (m_selectedPieceIndex != -1) {
         m_board.DrawLegalMoveHighlights(m_currentLegalMoves);
     }
 
-    m_board.DrawPieces(gameState.selectedPieceIndex);
+    m_board.DrawPieces(m_position, m_selectedPieceIndex);
 
-    if (gameState.selectedPieceIndex != -1) {
+    if (m_selectedPieceIndex != -1) {
         Vector2 mousePos = GetMousePosition();
-        const auto& pieceTextures = gameState.pieceTextures;
-        float scale = (float)SQUARE_SIZE / pieceTextures.at(gameState.board[gameState.selectedPieceIndex]).width * 0.8f;
+        const auto& pieceTextures = m_board.GetPieceTextures();
+        float scale = (float)SQUARE_SIZE / pieceTextures.at(m_position.board[m_selectedPieceIndex]).width * 0.8f;
         Vector2 centered = {
-            mousePos.x - m_dragOffset.x - (pieceTextures.at(gameState.board[gameState.selectedPieceIndex]).width * scale) / 2,
-            mousePos.y - m_dragOffset.y - (pieceTextures.at(gameState.board[gameState.selectedPieceIndex]).height * scale) / 2
+            mousePos.x - m_dragOffset.x - (pieceTextures.at(m_position.board[m_selectedPieceIndex]).width * scale) / 2,
+            mousePos.y - m_dragOffset.y - (pieceTextures.at(m_position.board[m_selectedPieceIndex]).height * scale) / 2
         };
-        DrawTextureEx(pieceTextures.at(gameState.board[gameState.selectedPieceIndex]), centered, 0.0f, scale, WHITE);
+        DrawTextureEx(pieceTextures.at(m_position.board[m_selectedPieceIndex]), centered, 0.0f, scale, WHITE);
     }
 
     EndDrawing();
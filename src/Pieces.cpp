@@ -1,324 +1,246 @@
 #include "include/Pieces.h"
-#include "include/Game.h"
 #include "include/CommonComponents.h"
+#include "include/BitboardOps.h"
 #include <iostream>
 #include <algorithm>
 
-PieceManager::PieceManager() {
-    m_directions = {
-        {0, 1}, {1, 0}, {0, -1}, {-1, 0},
-        {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
-    };
-}
-
- //Generate moves that slide. Goes all the way until it hits a piece or edge of board. Will work with Queen, Bishop, or Knight.
-std::vector<Move> PieceManager::GenerateSlidingMoves(int indexOnBoard, int pieceType) const {
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> moves;
-    int currentRow = indexOnBoard / 8;
-    int currentCol = indexOnBoard % 8;
-    int type = pieceType & 7;
-    bool checkDiagonal = (type == Piece::Bishop || type == Piece::Queen);
-    bool checkStraight = (type == Piece::Rook || type == Piece::Queen);
-
-    auto checkDirection = [&](int dirIndex) {
-        int newRow = currentRow;
-        int newCol = currentCol;
-        while (true) {
-            newRow += m_directions[dirIndex].first;
-            newCol += m_directions[dirIndex].second;
-            if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) {
-                break;  // Off the board
-            }
-            int target = newRow * 8 + newCol;
-            if (gameState.board[target] != Piece::None) {
-                // Add capture move if it's an opponent's piece
-                if ((gameState.board[target] & Piece::White) != (pieceType & Piece::White)) {
-                    moves.push_back({ indexOnBoard, target });
-                }
-                break;
-            }
-            moves.push_back({ indexOnBoard, target });
-        }
-    };
-
-    if (checkDiagonal) {
-        for (int i = 4; i < m_directions.size(); i++) {
-            checkDirection(i);
-        }
+namespace {
+    // Every piece of one colour that attacks the square, given an occupancy for the sliders to stop at
+    Bitboard AttackersOf(const Position& position, int square, bool byWhite, Bitboard occupancy) {
+        return position.attackersTo(square, occupancy) & position.colorOccupancy(byWhite);
     }
-    if (checkStraight) {
-        for (int i = 0; i < 4; i++) {
-            checkDirection(i);
-        }
-    }
-
-    return moves;
 }
 
-std::vector<Move> PieceManager::GenerateKnightMoves(int indexOnBoard, int pieceType) const {
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> moves;
-    int currentRow = indexOnBoard / 8;
-    int currentCol = indexOnBoard % 8;
-
-    // All possible knight moves
-    const std::vector<std::pair<int, int>> knightOffsets = {
-        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-        {1, -2}, {1, 2}, {2, -1}, {2, 1}
-    };
-
-    for (const auto& offset : knightOffsets) {
-        int newRow = currentRow + offset.first;
-        int newCol = currentCol + offset.second;
+// Generates only legal moves. Checkers, pinned pieces and the check evasion mask are worked out once
+// for the position, so no move has to be played and tested afterwards.
+void PieceManager::GenerateMoves(const Position& position, int color, MoveList& moves, MoveGenType type) const {
+    const PieceBitboards& bb = position.bitboards;
+    bool isWhite = color == Piece::White;
 
-        // Check if the new position is on the board
-        if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-            int target = newRow * 8 + newCol;
-
-            // Check if the square is empty or occupied by an opponent's piece
-            if (gameState.board[target] == Piece::None ||
-                ((gameState.board[target] & Piece::White) != (pieceType & Piece::White))) {
-                moves.push_back({ indexOnBoard, target });
-            }
-        }
+    Bitboard us(position.colorOccupancy(isWhite));
+    Bitboard them(position.colorOccupancy(!isWhite));
+    Bitboard occupancy = us | them;
+    int kingSquare = position.kingSquare(color);
+    if (kingSquare == -1) {
+        return;
     }
+    Bitboard checkers = AttackersOf(position, kingSquare, !isWhite, occupancy);
 
-    return moves;
-}
+    // Pawns sort out their own split, since a promotion push lands on an empty square but still counts as a capture
+    Bitboard typeMask = type == MoveGenType::Captures ? them : (type == MoveGenType::Quiets ? ~them : Bitboard(Bitboard::UNIVERSE));
 
-std::vector<Move> PieceManager::GeneratePawnMoves(int indexOnBoard, int pieceType) const {
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> moves;
-    int currentRow = indexOnBoard / 8;
-    int currentCol = indexOnBoard % 8;
+    GenerateKingMoves(position, kingSquare, Piece::King | color, occupancy, typeMask, moves);
 
-    // Determine direction based on color
-    int direction = (pieceType & Piece::White) ? -1 : 1;
+    // In double check only the king can move
+    if (checkers.count() > 1) {
+        return;
+    }
 
-    // Check forward move
-    int newRow = currentRow + direction;
-    if (newRow >= 0 && newRow < 8) {
-        int target = newRow * 8 + currentCol;
-        if (gameState.board[target] == Piece::None) {
-            Move move = { indexOnBoard, target };
-            moves.push_back(move);
-            // Check double move if it's the pawn's first move
-            if ((direction == -1 && currentRow == 6) || (direction == 1 && currentRow == 1)) {
-                newRow += direction;
-                target = newRow * 8 + currentCol;
-                if (gameState.board[target] == Piece::None) {
-                    moves.push_back({ indexOnBoard, target });
-                }
+    // In single check every other move has to capture the checker or block its ray
+    Bitboard checkMask(Bitboard::UNIVERSE);
+    if (checkers) {
+        checkMask = BitboardOps::between(kingSquare, checkers.lsb()) | checkers;
+    }
+    else if (type != MoveGenType::Captures) {
+        for (bool kingSide : { true, false }) {
+            if (CanCastle(position, Piece::King | color, kingSide, occupancy)) {
+                Move castlingMove(kingSquare, kingSquare + (kingSide ? 2 : -2), Move::Castling);
+                moves.push_back(castlingMove);
             }
         }
     }
 
-    // Check diagonal captures
-    for (int colOffset : {-1, 1}) {
-        int newCol = currentCol + colOffset;
-        if (newCol >= 0 && newCol < 8) {
-            int target = (currentRow + direction) * 8 + newCol;
-            if (gameState.board[target] != Piece::None &&
-                ((gameState.board[target] & Piece::White) != (pieceType & Piece::White))) {
-                Move move = { indexOnBoard, target };
-                // Check for promotion
-                if ((direction == -1 && newRow == 0) || (direction == 1 && newRow == 7)) {
-                    move.isPromotion = true;
-                }
-                moves.push_back(move);
-            }
+    // A piece is pinned when it is the only thing standing between our king and an enemy slider
+    Bitboard pinned;
+    Bitboard snipers =
+        (BitboardOps::rookAttacks(kingSquare, Bitboard()) & (isWhite ? (bb.BlackRooks | bb.BlackQueens) : (bb.WhiteRooks | bb.WhiteQueens))) |
+        (BitboardOps::bishopAttacks(kingSquare, Bitboard()) & (isWhite ? (bb.BlackBishops | bb.BlackQueens) : (bb.WhiteBishops | bb.WhiteQueens)));
+    while (snipers) {
+        Bitboard blockers = BitboardOps::between(kingSquare, snipers.popLsb()) & occupancy;
+        if (blockers.count() == 1 && (blockers & us)) {
+            pinned |= blockers;
         }
     }
 
-    if (gameState.gameFlags.enPassantTargetSquare != -1) {
-        // Check if the current pawn is in the correct position to make an en passant capture
-        if ((pieceType & Piece::White && indexOnBoard / 8 == 3) ||
-            (pieceType & Piece::Black && indexOnBoard / 8 == 4)) {
-            // Check if the en passant target is adjacent to the pawn
-            if (abs(indexOnBoard % 8 - gameState.gameFlags.enPassantTargetSquare % 8) == 1) {
-                Move enPassantMove;
-                enPassantMove.startSquare = indexOnBoard;
-                enPassantMove.targetSquare = gameState.gameFlags.enPassantTargetSquare;
-                enPassantMove.isEnPassant = true;
-                moves.push_back(enPassantMove);
+    // Pinned pieces may only slide along the line through the king
+    auto allowedFor = [&](int square) {
+        return pinned.isOccupied(square) ? (checkMask & BitboardOps::line(kingSquare, square)) : checkMask;
+    };
+
+    Bitboard pawns = isWhite ? bb.WhitePawns : bb.BlackPawns;
+    Bitboard knights = (isWhite ? bb.WhiteKnights : bb.BlackKnights) & ~pinned;  // A pinned knight can never move
+    Bitboard sliders = isWhite ? (bb.WhiteBishops | bb.WhiteRooks | bb.WhiteQueens)
+                               : (bb.BlackBishops | bb.BlackRooks | bb.BlackQueens);
+
+    while (pawns) {
+        int square = pawns.popLsb();
+        GeneratePawnMoves(position, square, Piece::Pawn | color, allowedFor(square), moves, type);
+    }
+    while (knights) {
+        GenerateKnightMoves(position, knights.popLsb(), Piece::Knight | color, checkMask & typeMask, moves);
+    }
+    while (sliders) {
+        int square = sliders.popLsb();
+        GenerateSlidingMoves(position, square, position.board[square], occupancy, allowedFor(square) & typeMask, moves);
+    }
+
+    // En passant takes two pieces off one rank at once, which the pin test above can't see.
+    // Replay the capture on the occupancy and check the king directly instead.
+    int enPassantSquare = position.gameFlags.enPassantTargetSquare;
+    if (enPassantSquare != -1 && type != MoveGenType::Quiets) {
+        int capturedSquare = enPassantSquare + (isWhite ? 8 : -8);
+        Bitboard captured = Bitboard::fromSquare(capturedSquare);
+        Bitboard capturers = BitboardOps::PawnAttacks[isWhite ? 1 : 0][enPassantSquare] & (isWhite ? bb.WhitePawns : bb.BlackPawns);
+        while (capturers) {
+            int from = capturers.popLsb();
+            Bitboard after = (occupancy ^ Bitboard::fromSquare(from) ^ captured) | Bitboard::fromSquare(enPassantSquare);
+            if (!(AttackersOf(position, kingSquare, !isWhite, after) & ~captured)) {
+                moves.push_back(Move(from, enPassantSquare, Move::EnPassant));
             }
         }
     }
-
-    return moves;
 }
 
-std::vector<Move> PieceManager::GenerateKingMoves(int indexOnBoard, int pieceType, const Game& game) const {
-    auto& gameState = GameState::getInstance();
-    std::vector<Move> moves;
-    int currentRow = indexOnBoard / 8;
-    int currentCol = indexOnBoard % 8;
+// Generate moves that slide. Looks the attack set up in the magic tables and drops squares holding our own pieces.
+// Will work with Queen, Bishop, or Rook.
+void PieceManager::GenerateSlidingMoves(const Position& position, int indexOnBoard, int pieceType, Bitboard occupancy, Bitboard allowed, MoveList& moves) const {
+    Bitboard own(position.colorOccupancy((pieceType & Piece::White) != 0));
 
-    // Generate all moves surrounding king
-    for (int i = 0; i < 8; i++) {
-        int newRow = currentRow + m_directions[i].first;
-        int newCol = currentCol + m_directions[i].second;
-
-        if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) {
-            continue;  // Off the board
-        }
-        int target = (newRow * 8) + newCol;
-        if (gameState.board[target] != Piece::None) {
-            // Add capture move if it's an opponent's piece
-            if ((gameState.board[target] & Piece::White) != (pieceType & Piece::White)) {
-                moves.push_back({ indexOnBoard, target });
-            }
-            continue;
-        }
-        moves.push_back({ indexOnBoard, target });
+    Bitboard attacks;
+    switch (pieceType & 7) {
+    case Piece::Bishop: attacks = BitboardOps::bishopAttacks(indexOnBoard, occupancy); break;
+    case Piece::Rook: attacks = BitboardOps::rookAttacks(indexOnBoard, occupancy); break;
+    case Piece::Queen: attacks = BitboardOps::queenAttacks(indexOnBoard, occupancy); break;
+    default: return;
     }
+    attacks &= ~own & allowed;
 
-    // Castle if available
-    if (this->CanCastle(pieceType, true, game)) {  // Kingside
-        Move castlingMove;
-        castlingMove.startSquare = indexOnBoard;
-        castlingMove.targetSquare = indexOnBoard + 2;
-        castlingMove.isCastling = true;
-        castlingMove.rookStartSquare = (pieceType & Piece::White) ? ChessSquares::H1 : ChessSquares::H8;
-        castlingMove.rookTargetSquare = castlingMove.rookStartSquare - 2;
-        moves.push_back(castlingMove);
+    while (attacks) {
+        moves.push_back(Move(indexOnBoard, attacks.popLsb()));
     }
+}
+
+void PieceManager::GenerateKnightMoves(const Position& position, int indexOnBoard, int pieceType, Bitboard allowed, MoveList& moves) const {
+    // Any square the knight attacks that isn't holding one of our own pieces
+    Bitboard targets = BitboardOps::KnightAttacks[indexOnBoard] & allowed &
+        ~position.colorOccupancy((pieceType & Piece::White) != 0);
 
-    if (this->CanCastle(pieceType, false, game)) {  // Queenside
-        Move castlingMove;
-        castlingMove.startSquare = indexOnBoard;
-        castlingMove.targetSquare = indexOnBoard - 2;
-        castlingMove.isCastling = true;
-        castlingMove.rookStartSquare = (pieceType & Piece::White) ? ChessSquares::A1 : ChessSquares::A8;
-        castlingMove.rookTargetSquare = castlingMove.rookStartSquare + 3;
-        moves.push_back(castlingMove);
+    while (targets) {
+        moves.push_back(Move(indexOnBoard, targets.popLsb()));
     }
-    std::cout << "King Moves Generated: " << moves.size() << std::endl;
-    return moves;
 }
 
+// Pushes, double pushes and captures. En passant is handled by GenerateMoves.
+// Promotions, pushes included, go with the captures; other pushes are quiet.
+void PieceManager::GeneratePawnMoves(const Position& position, int indexOnBoard, int pieceType, Bitboard allowed, MoveList& moves, MoveGenType type) const {
+    bool isWhite = (pieceType & Piece::White) != 0;
+    int direction = isWhite ? -8 : 8;
+    int currentRow = indexOnBoard / 8;
+    int promotionRow = isWhite ? 0 : 7;
+    bool promotes = (indexOnBoard + direction) / 8 == promotionRow;
+    bool wantPushes = promotes ? type != MoveGenType::Quiets : type != MoveGenType::Captures;
+
+    // Reaching the last rank gives one move per promotion piece, queen first so the GUI picks it by default
+    auto addMove = [&](int target) {
+        if (target / 8 == promotionRow) {
+            for (int promotionType : { Piece::Queen, Piece::Rook, Piece::Bishop, Piece::Knight }) {
+                moves.push_back(Move(indexOnBoard, target, Move::Promotion, promotionType));
+            }
+        }
+        else {
+            moves.push_back(Move(indexOnBoard, target));
+        }
+    };
 
-bool PieceManager::CanCastle(int kingType, bool kingSide, const Game& game) const {
-    auto& gameState = GameState::getInstance();
-    int kingColor = (kingType & Piece::White) ? Piece::White : Piece::Black;
-    int oppositeColor = (kingColor == Piece::White) ? Piece::Black : Piece::White;
-    int kingStartSquare = (kingColor == Piece::White) ? ChessSquares::E1 : ChessSquares::E8;
-
-    // Check if king or rook has moved
-    if (kingColor == Piece::White) {
-        if (gameState.gameFlags.whiteKingHasMoved) return false;
-        if (kingSide && gameState.gameFlags.h1RookHasMoved) return false;
-        if (!kingSide && gameState.gameFlags.a1RookHasMoved) return false;
-    }
-    else {
-        if (gameState.gameFlags.blackKingHasMoved) return false;
-        if (kingSide && gameState.gameFlags.h8RookHasMoved) return false;
-        if (!kingSide && gameState.gameFlags.a8RookHasMoved) return false;
+    // Check forward move
+    int target = indexOnBoard + direction;
+    if (wantPushes && position.board[target] == Piece::None) {
+        if (allowed.isOccupied(target)) {
+            addMove(target);
+        }
+        // Check double move if it's the pawn's first move
+        int doubleTarget = target + direction;
+        if (currentRow == (isWhite ? 6 : 1) && position.board[doubleTarget] == Piece::None && allowed.isOccupied(doubleTarget)) {
+            addMove(doubleTarget);
+        }
     }
 
-    // Check if squares between king and rook are empty
-    int direction = kingSide ? 1 : -1;
-    for (int i = 1; i <= (kingSide ? 2 : 3); i++) {
-        if (gameState.board[kingStartSquare + i * direction] != Piece::None) return false;
+    // Check diagonal captures
+    if (type == MoveGenType::Quiets) {
+        return;
     }
-
-    // Check if king is in check or passes through attacked square
-    for (int i = 0; i <= 2; i++) {
-        if (game.IsSquareAttackedSimple(kingStartSquare + i * direction, oppositeColor)) return false;
+    Bitboard captures = BitboardOps::PawnAttacks[isWhite ? 0 : 1][indexOnBoard] & allowed &
+        position.colorOccupancy(!isWhite);
+    while (captures) {
+        addMove(captures.popLsb());
     }
-
-    return true;
 }
 
-// Standalone function to update bitboards
-void PieceManager::UpdateBitboards(const Move& move, int currentPiece) {
-    auto& gameState = GameState::getInstance();
-
-    // Helper function to get a pointer to the appropriate Bitboard
-    auto getBitboard = [&](int pieceType) -> Bitboard* {
-        switch (pieceType) {
-        case Piece::WhitePawn: return &gameState.bitboards.WhitePawns;
-        case Piece::WhiteKnight: return &gameState.bitboards.WhiteKnights;
-        case Piece::WhiteBishop: return &gameState.bitboards.WhiteBishops;
-        case Piece::WhiteRook: return &gameState.bitboards.WhiteRooks;
-        case Piece::WhiteQueen: return &gameState.bitboards.WhiteQueens;
-        case Piece::WhiteKing: return &gameState.bitboards.WhiteKing;
-        case Piece::BlackPawn: return &gameState.bitboards.BlackPawns;
-        case Piece::BlackKnight: return &gameState.bitboards.BlackKnights;
-        case Piece::BlackBishop: return &gameState.bitboards.BlackBishops;
-        case Piece::BlackRook: return &gameState.bitboards.BlackRooks;
-        case Piece::BlackQueen: return &gameState.bitboards.BlackQueens;
-        case Piece::BlackKing: return &gameState.bitboards.BlackKing;
-        default:
-            throw std::invalid_argument("Invalid piece type in getBitboard");
+// King steps, skipping any square the enemy attacks. The king is lifted off the occupancy first
+// so a slider checking along a line also covers the square directly behind the king.
+void PieceManager::GenerateKingMoves(const Position& position, int indexOnBoard, int pieceType, Bitboard occupancy, Bitboard allowed, MoveList& moves) const {
+    bool isWhite = (pieceType & Piece::White) != 0;
+    Bitboard withoutKing = occupancy & ~Bitboard::fromSquare(indexOnBoard);
+
+    Bitboard targets = BitboardOps::KingAttacks[indexOnBoard] & allowed & ~position.colorOccupancy(isWhite);
+    while (targets) {
+        int target = targets.popLsb();
+        if (!AttackersOf(position, target, !isWhite, withoutKing)) {
+            moves.push_back(Move(indexOnBoard, target));
         }
-    };
-
-    // Get the bitboard for the current piece
-    Bitboard* currentBitboard = getBitboard(currentPiece);
-
-    // Update the bitboard for the moving piece
-    currentBitboard->clear(move.startSquare);
-    currentBitboard->set(move.targetSquare);
+    }
+}
 
-    // Create a mask for clearing the captured piece (if any)
-    Bitboard::BitboardType captureMask = ~(1ULL << move.targetSquare);
+// Assumes the king is not in check; GenerateMoves only asks when it isn't
+bool PieceManager::CanCastle(const Position& position, int kingType, bool kingSide, Bitboard occupancy) const {
+    bool isWhite = (kingType & Piece::White) != 0;
+    int kingStartSquare = isWhite ? ChessSquares::E1 : ChessSquares::E8;
+    int rookSquare;
 
-    // Clear the captured piece from all other bitboards
-    for (int pieceType : {Piece::WhitePawn, Piece::WhiteKnight, Piece::WhiteBishop, Piece::WhiteRook, Piece::WhiteQueen, Piece::WhiteKing,
-        Piece::BlackPawn, Piece::BlackKnight, Piece::BlackBishop, Piece::BlackRook, Piece::BlackQueen, Piece::BlackKing}) {
-        if (pieceType != currentPiece) {
-            getBitboard(pieceType)->board &= captureMask;
-        }
+    // Check if king or rook has moved
+    if (isWhite) {
+        if (position.gameFlags.whiteKingHasMoved) return false;
+        if (kingSide && position.gameFlags.h1RookHasMoved) return false;
+        if (!kingSide && position.gameFlags.a1RookHasMoved) return false;
+        rookSquare = kingSide ? ChessSquares::H1 : ChessSquares::A1;
     }
-
-    // Handle special moves
-    if (move.isEnPassant) {
-        int capturedPawnSquare = move.targetSquare + ((currentPiece & Piece::White) ? 8 : -8);
-        getBitboard((currentPiece & Piece::White) ? Piece::BlackPawn : Piece::WhitePawn)->clear(capturedPawnSquare);
+    else {
+        if (position.gameFlags.blackKingHasMoved) return false;
+        if (kingSide && position.gameFlags.h8RookHasMoved) return false;
+        if (!kingSide && position.gameFlags.a8RookHasMoved) return false;
+        rookSquare = kingSide ? ChessSquares::H8 : ChessSquares::A8;
     }
-    else if (move.isCastling) {
-        // Update rook position for castling
-        Bitboard* rookBitboard = getBitboard((currentPiece & Piece::White) ? Piece::WhiteRook : Piece::BlackRook);
-        rookBitboard->clear(move.rookStartSquare);
-        rookBitboard->set(move.rookTargetSquare);
+    if (position.board[kingStartSquare] != kingType || position.board[rookSquare] != (Piece::Rook | (kingType & 0b11000))) {
+        return false;
     }
 
-    // Handle pawn promotion
-    if (move.isPromotion) {
-        currentBitboard->clear(move.targetSquare);  // Remove pawn from its bitboard
-        getBitboard(move.promotionPiece)->set(move.targetSquare);  // Add the promoted piece to its bitboard
+    // Check if squares between king and rook are empty
+    if (BitboardOps::between(kingStartSquare, rookSquare) & occupancy) {
+        return false;
     }
-}
 
-int PieceManager::FindKingLocation(int kingColor) const {
-    auto& gameState = GameState::getInstance();
-    int targetKing = (kingColor & Piece::White) ? Piece::WhiteKing : Piece::BlackKing;
-
-    for (int i = 0; i < TOTAL_SQUARES; i++) {
-        if (gameState.board[i] == targetKing) {
-            return i;
-        }
+    // Check the king doesn't pass through or land on an attacked square
+    int direction = kingSide ? 1 : -1;
+    for (int i = 1; i <= 2; i++) {
+        if (AttackersOf(position, kingStartSquare + i * direction, !isWhite, occupancy)) return false;
     }
 
-    return -1;  // King not found (shouldn't happen in a valid chess position)
+    return true;
 }
 
-void PieceManager::ClearAllBitboards() {
-    auto& gameState = GameState::getInstance();
+void PieceManager::ClearAllBitboards(Position& position) {
     // Implement the ClearAllBitboards function here
     // This function was declared in the header but not implemented in the original code
-    gameState.bitboards.WhitePawns.board = 0;
-    gameState.bitboards.WhiteKnights.board = 0;
-    gameState.bitboards.WhiteBishops.board = 0;
-    gameState.bitboards.WhiteRooks.board = 0;
-    gameState.bitboards.WhiteQueens.board = 0;
-    gameState.bitboards.WhiteKing.board = 0;
-    gameState.bitboards.BlackPawns.board = 0;
-    gameState.bitboards.BlackKnights.board = 0;
-    gameState.bitboards.BlackBishops.board = 0;
-    gameState.bitboards.BlackRooks.board = 0;
-    gameState.bitboards.BlackQueens.board = 0;
-    gameState.bitboards.BlackKing.board = 0;
+    position.bitboards.WhitePawns.board = 0;
+    position.bitboards.WhiteKnights.board = 0;
+    position.bitboards.WhiteBishops.board = 0;
+    position.bitboards.WhiteRooks.board = 0;
+    position.bitboards.WhiteQueens.board = 0;
+    position.bitboards.WhiteKing.board = 0;
+    position.bitboards.BlackPawns.board = 0;
+    position.bitboards.BlackKnights.board = 0;
+    position.bitboards.BlackBishops.board = 0;
+    position.bitboards.BlackRooks.board = 0;
+    position.bitboards.BlackQueens.board = 0;
+    position.bitboards.BlackKing.board = 0;
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 #include <cstdint>
-#include <functional>
-#include "Pieces.h"
-#include "CommonComponents.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // Forward declaration of PieceBitboards
 struct PieceBitboards;
 
+// Header-only so every operation can be inlined at the call site. Square arguments are
+// not range checked; callers must pass 0-63.
 class Bitboard {
 public:
     using BitboardType = uint64_t;
@@ -18,12 +20,54 @@ public:
     // Constructors
     BitboardType board;
 
-    Bitboard() : board(EMPTY) {}
-    explicit Bitboard(BitboardType value) : board(value) {}
+    constexpr Bitboard() : board(EMPTY) {}
+    constexpr Bitboard(BitboardType value) : board(value) {}
+
+    static constexpr Bitboard fromSquare(int square) { return Bitboard(1ULL << square); }
 
     // Basic operations
-    void set(int square);
-    void clear(int square);
-    bool isOccupied(int square) const;
+    constexpr void set(int square) { board |= (1ULL << square); }
+    constexpr void clear(int square) { board &= ~(1ULL << square); }
+    constexpr bool isOccupied(int square) const { return (board & (1ULL << square)) != 0; }
+    constexpr bool empty() const { return board == 0; }
+    constexpr explicit operator bool() const { return board != 0; }
+
+    // Number of set bits (popcnt)
+    int count() const {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(board));
+#else
+        return __builtin_popcountll(board);
+#endif
+    }
+
+    // Index of the least significant set bit (tzcnt). Undefined for an empty board.
+    int lsb() const {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, board);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(board);
+#endif
+    }
+
+    // Removes the least significant set bit and returns its index. Undefined for an empty board.
+    int popLsb() {
+        int square = lsb();
+        board &= board - 1;
+        return square;
+    }
 
-};
\ No newline at end of file
+    constexpr Bitboard operator&(Bitboard other) const { return Bitboard(board & other.board); }
+    constexpr Bitboard operator|(Bitboard other) const { return Bitboard(board | other.board); }
+    constexpr Bitboard operator^(Bitboard other) const { return Bitboard(board ^ other.board); }
+    constexpr Bitboard operator~() const { return Bitboard(~board); }
+    constexpr Bitboard operator<<(int shift) const { return Bitboard(board << shift); }
+    constexpr Bitboard operator>>(int shift) const { return Bitboard(board >> shift); }
+    constexpr Bitboard& operator&=(Bitboard other) { board &= other.board; return *this; }
+    constexpr Bitboard& operator|=(Bitboard other) { board |= other.board; return *this; }
+    constexpr Bitboard& operator^=(Bitboard other) { board ^= other.board; return *this; }
+    constexpr bool operator==(Bitboard other) const { return board == other.board; }
+    constexpr bool operator!=(Bitboard other) const { return board != other.board; }
+};
@@ -1,21 +1,111 @@
 #pragma once
-#include "Bitboard.h"
+#include "BitBoard.h"
+#include <array>
 
 namespace BitboardOps {
-    Bitboard northOne(Bitboard b);
-    Bitboard southOne(Bitboard b);
-    Bitboard eastOne(Bitboard b);
-    Bitboard westOne(Bitboard b);
-    Bitboard northEastOne(Bitboard b);
-    Bitboard northWestOne(Bitboard b);
-    Bitboard southEastOne(Bitboard b);
-    Bitboard southWestOne(Bitboard b);
-
-    Bitboard getLSB(Bitboard b);
-    Bitboard popLSB(Bitboard& b);
-    int bitScanForward(Bitboard b);
-
     // Constants
-    const Bitboard NOT_A_FILE = Bitboard(0xfefefefefefefefe);  // ~0x0101010101010101
-    const Bitboard NOT_H_FILE = Bitboard(0x7f7f7f7f7f7f7f7f);  // ~0x8080808080808080
-}
\ No newline at end of file
+    constexpr Bitboard NOT_A_FILE = Bitboard(0xfefefefefefefefe);  // ~0x0101010101010101
+    constexpr Bitboard NOT_H_FILE = Bitboard(0x7f7f7f7f7f7f7f7f);  // ~0x8080808080808080
+
+    // Squares follow the mailbox layout (A8 = 0, H1 = 63), so "north" is towards index 0
+    constexpr Bitboard northOne(Bitboard b) { return b >> 8; }
+    constexpr Bitboard southOne(Bitboard b) { return b << 8; }
+    constexpr Bitboard eastOne(Bitboard b) { return (b << 1) & NOT_A_FILE; }
+    constexpr Bitboard westOne(Bitboard b) { return (b >> 1) & NOT_H_FILE; }
+    constexpr Bitboard northEastOne(Bitboard b) { return (b >> 7) & NOT_A_FILE; }
+    constexpr Bitboard northWestOne(Bitboard b) { return (b >> 9) & NOT_H_FILE; }
+    constexpr Bitboard southEastOne(Bitboard b) { return (b << 9) & NOT_A_FILE; }
+    constexpr Bitboard southWestOne(Bitboard b) { return (b << 7) & NOT_H_FILE; }
+
+    constexpr Bitboard getLSB(Bitboard b) { return Bitboard(b.board & (~b.board + 1)); }
+
+    // Returns the LSB and also removes it from the input
+    constexpr Bitboard popLSB(Bitboard& b) {
+        Bitboard result = getLSB(b);
+        b ^= result;
+        return result;
+    }
+
+    inline int bitScanForward(Bitboard b) { return b.empty() ? -1 : b.lsb(); }
+    inline int popCount(Bitboard b) { return b.count(); }
+
+    // Leaper attack tables, built at compile time. Pawn tables are indexed by colour
+    // (0 = white, 1 = black) and hold capture targets only.
+    namespace detail {
+        constexpr Bitboard knightAttacksFrom(int square) {
+            Bitboard b = Bitboard::fromSquare(square);
+            Bitboard east = eastOne(b), west = westOne(b);
+            Bitboard attacks = northOne(northOne(east | west)) | southOne(southOne(east | west));
+            Bitboard eastEast = eastOne(east), westWest = westOne(west);
+            return attacks | northOne(eastEast | westWest) | southOne(eastEast | westWest);
+        }
+
+        constexpr Bitboard kingAttacksFrom(int square) {
+            Bitboard b = Bitboard::fromSquare(square);
+            Bitboard row = b | eastOne(b) | westOne(b);
+            return (row | northOne(row) | southOne(row)) ^ b;
+        }
+
+        constexpr Bitboard pawnAttacksFrom(int color, int square) {
+            Bitboard b = Bitboard::fromSquare(square);
+            return color == 0 ? northEastOne(b) | northWestOne(b) : southEastOne(b) | southWestOne(b);
+        }
+
+        template <typename Generator>
+        constexpr std::array<Bitboard, 64> buildTable(Generator generator) {
+            std::array<Bitboard, 64> table{};
+            for (int square = 0; square < 64; square++) {
+                table[square] = generator(square);
+            }
+            return table;
+        }
+    }
+
+    inline constexpr std::array<Bitboard, 64> KnightAttacks = detail::buildTable(detail::knightAttacksFrom);
+    inline constexpr std::array<Bitboard, 64> KingAttacks = detail::buildTable(detail::kingAttacksFrom);
+    inline constexpr std::array<std::array<Bitboard, 64>, 2> PawnAttacks = {
+        detail::buildTable([](int square) { return detail::pawnAttacksFrom(0, square); }),
+        detail::buildTable([](int square) { return detail::pawnAttacksFrom(1, square); })
+    };
+
+    // Magic bitboard entry for one square. The relevant occupancy bits are multiplied by the magic
+    // and the top bits of the product index straight into that square's slice of the attack table.
+    struct Magic {
+        Bitboard::BitboardType mask;
+        Bitboard::BitboardType magic;
+        Bitboard::BitboardType* attacks;
+        unsigned shift;
+
+        unsigned index(Bitboard::BitboardType occupancy) const {
+            return static_cast<unsigned>(((occupancy & mask) * magic) >> shift);
+        }
+    };
+
+    extern Magic RookMagics[64];
+    extern Magic BishopMagics[64];
+
+    // Squares strictly between two squares sharing a rank, file or diagonal, and the whole line
+    // through them. Both are empty for squares that aren't aligned.
+    extern Bitboard BetweenSquares[64][64];
+    extern Bitboard LineThrough[64][64];
+
+    // Builds the rook, bishop, between and line tables. Call once at startup before generating any moves.
+    void initSlidingAttacks();
+
+    inline Bitboard rookAttacks(int square, Bitboard occupancy) {
+        const Magic& m = RookMagics[square];
+        return Bitboard(m.attacks[m.index(occupancy.board)]);
+    }
+
+    inline Bitboard bishopAttacks(int square, Bitboard occupancy) {
+        const Magic& m = BishopMagics[square];
+        return Bitboard(m.attacks[m.index(occupancy.board)]);
+    }
+
+    inline Bitboard queenAttacks(int square, Bitboard occupancy) {
+        return rookAttacks(square, occupancy) | bishopAttacks(square, occupancy);
+    }
+
+    inline Bitboard between(int from, int to) { return BetweenSquares[from][to]; }
+    inline Bitboard line(int from, int to) { return LineThrough[from][to]; }
+}
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "CommonComponents.h"
-#include "Bitboard.h"
+#include "BitBoard.h"
 #include "Pieces.h"
-#include "GameState.h"
+#include "Position.h"
 #include <unordered_map>
 #include "raylib.h"
 #include <string>
@@ -12,27 +12,35 @@ const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 800;
 const int SQUARE_SIZE = SCREEN_WIDTH / BOARD_SIZE;
 
+struct Square {
+    Rectangle bounds;
+    Vector2 center;
+};
+
+struct ChessPiece {
+    int type;
+    Vector2 position;
+    Vector2 midpoint;
+};
+
 class ChessBoard {
 public:
     ChessBoard();
-    void InitializeBoard();
+    void InitializeBoard(Position& position);
     void LoadPieceTextures();
     void UnloadPieceTextures();
+    const std::unordered_map<int, Texture2D>& GetPieceTextures() const;
     void DrawChessBoard();
-    void DrawPieces(int selectedPieceIndex) const;
+    void DrawPieces(const Position& position, int selectedPieceIndex) const;
     void DrawLegalMoveHighlights(const std::vector<Move>& legalMoves);
-    void UpdateChessPieces();
-    void UpdateGameFlags(int selectedPieceIndex);
+    void UpdateChessPieces(const Position& position);
 
 
 private:
-    void SetBoardFromFEN(const std::string& fen);
-    void UpdateBitboardsFromBoard();
     void InitializeBoardSquares();
-    void InitializeChessPieces();
-    int ConvertToBitboardIndex(int boardIndex) const;
+    void InitializeChessPieces(const Position& position);
 
     std::array<Square, TOTAL_SQUARES> m_boardSquares;
     std::array<ChessPiece, 32> m_chessPieces;
-    PieceManager m_pieceManager;
+    std::unordered_map<int, Texture2D> m_pieceTextures;
 };
\ No newline at end of file
@@ -1,22 +1,113 @@
 #pragma once
 #include <array>
-#include "raylib.h"
+#include <cstdint>
+#include <type_traits>
+#include <functional>
+#include "BitBoard.h"
 
 const int BOARD_SIZE = 8;
 const int TOTAL_SQUARES = 64;
 
+// Piece definitions
+class Piece {
+public:
+    static constexpr int None = 0;
+    static constexpr int Pawn = 1;
+    static constexpr int Knight = 2;
+    static constexpr int Bishop = 3;
+    static constexpr int Rook = 4;
+    static constexpr int Queen = 5;
+    static constexpr int King = 6;
+    static constexpr int White = 8;
+    static constexpr int Black = 16;
+    static constexpr int WhitePawn = Piece::Pawn | Piece::White;
+    static constexpr int WhiteKnight = Piece::Knight | Piece::White;
+    static constexpr int WhiteBishop = Piece::Bishop | Piece::White;
+    static constexpr int WhiteRook = Piece::Rook | Piece::White;
+    static constexpr int WhiteQueen = Piece::Queen | Piece::White;
+    static constexpr int WhiteKing = Piece::King | Piece::White;
+    static constexpr int BlackPawn = Piece::Pawn | Piece::Black;
+    static constexpr int BlackKnight = Piece::Knight | Piece::Black;
+    static constexpr int BlackBishop = Piece::Bishop | Piece::Black;
+    static constexpr int BlackRook = Piece::Rook | Piece::Black;
+    static constexpr int BlackQueen = Piece::Queen | Piece::Black;
+    static constexpr int BlackKing = Piece::King | Piece::Black;
+
+    // 0-11 for the twelve coloured pieces, white first. Used to index per-piece tables.
+    static constexpr int index(int piece) { return (piece & 7) - 1 + ((piece & Black) ? 6 : 0); }
+};
+
 using BoardState = std::array<int, TOTAL_SQUARES>;
 
-struct Move {
-    int startSquare;
-    int targetSquare;
-    int moveCount;
-    bool isCastling = false;
-    int rookStartSquare = -1;
-    int rookTargetSquare = -1;
-    bool isEnPassant = false;
-    bool isPromotion = false;
-    int promotionPiece;
+// A move packed into 16 bits: start square (bits 0-5), target square (6-11), promotion piece
+// type minus Knight (12-13) and the kind of move (14-15). All zero bits is the empty "no move".
+// Default construction leaves it uninitialised, like an int, so a MoveList costs nothing to create.
+class Move {
+public:
+    enum Type : uint16_t { Normal = 0, Promotion = 1, EnPassant = 2, Castling = 3 };
+
+    Move() = default;
+    constexpr Move(int startSquare, int targetSquare, Type type = Normal, int promotionType = Piece::Knight)
+        : m_data(static_cast<uint16_t>(startSquare | (targetSquare << 6) | ((promotionType - Piece::Knight) << 12) | (type << 14))) {}
+
+    constexpr int startSquare() const { return m_data & 0x3F; }
+    constexpr int targetSquare() const { return (m_data >> 6) & 0x3F; }
+    constexpr Type type() const { return static_cast<Type>(m_data >> 14); }
+    constexpr bool isPromotion() const { return type() == Promotion; }
+    constexpr bool isEnPassant() const { return type() == EnPassant; }
+    constexpr bool isCastling() const { return type() == Castling; }
+
+    // Knight, Bishop, Rook or Queen, without a colour. Only meaningful for promotions.
+    constexpr int promotionType() const { return ((m_data >> 12) & 3) + Piece::Knight; }
+
+    // The rook's squares follow from which way the king went
+    constexpr int rookStartSquare() const { return targetSquare() > startSquare() ? startSquare() + 3 : startSquare() - 4; }
+    constexpr int rookTargetSquare() const { return targetSquare() > startSquare() ? startSquare() + 1 : startSquare() - 1; }
+
+    static constexpr Move none() { return Move(0, 0); }
+
+    constexpr uint16_t raw() const { return m_data; }
+    static constexpr Move fromRaw(uint16_t data) {
+        Move move = none();
+        move.m_data = data;
+        return move;
+    }
+    constexpr bool isNone() const { return m_data == 0; }
+    constexpr bool operator==(Move other) const { return m_data == other.m_data; }
+    constexpr bool operator!=(Move other) const { return m_data != other.m_data; }
+
+private:
+    uint16_t m_data;
+};
+
+static_assert(sizeof(Move) == 2, "Move should pack into 16 bits");
+static_assert(std::is_trivially_default_constructible<Move>::value, "Move lists shouldn't pay to construct");
+
+const int MAX_MOVES = 256;
+
+// Which moves a generator call produces. Captures also takes in en passant and every promotion,
+// so Captures and Quiets together give exactly All.
+enum class MoveGenType { All, Captures, Quiets };
+
+enum class GameResult { Ongoing, WhiteWins, BlackWins, Draw };
+
+// Fixed-capacity move buffer meant to live on the stack. No legal chess position has more
+// than 218 moves, so 256 leaves room for pseudo-legal moves too.
+struct MoveList {
+    std::array<Move, MAX_MOVES> moves;
+    int count = 0;
+
+    void push_back(const Move& move) { moves[count++] = move; }
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int index) { return moves[index]; }
+    const Move& operator[](int index) const { return moves[index]; }
+    Move* begin() { return moves.data(); }
+    Move* end() { return moves.data() + count; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + count; }
 };
 
 struct GameRuleFlags {
@@ -30,9 +121,17 @@ struct GameRuleFlags {
     bool h8RookHasMoved = false;
     bool blackKingHasMoved = false;
 
-    int enPassantTargetSquare;
+    int enPassantTargetSquare = -1;
 
     int halfMoveClock = 0;
+
+    // Castling rights still available as a 4-bit mask: 1 = K, 2 = Q, 4 = k, 8 = q
+    int castlingRights() const {
+        return (!whiteKingHasMoved && !h1RookHasMoved ? 1 : 0)
+             | (!whiteKingHasMoved && !a1RookHasMoved ? 2 : 0)
+             | (!blackKingHasMoved && !h8RookHasMoved ? 4 : 0)
+             | (!blackKingHasMoved && !a8RookHasMoved ? 8 : 0);
+    }
 };
 
 struct ChessSquares {
@@ -70,17 +169,30 @@ struct PieceBitboards {
     Bitboard BlackQueens = 0ULL;
     Bitboard WhiteKing = 0ULL;
     Bitboard BlackKing = 0ULL;
-};
 
-struct Square {
-    Rectangle bounds;
-    Vector2 center;
+    Bitboard& forPiece(int piece) {
+        switch (piece) {
+        case Piece::WhitePawn: return WhitePawns;
+        case Piece::WhiteKnight: return WhiteKnights;
+        case Piece::WhiteBishop: return WhiteBishops;
+        case Piece::WhiteRook: return WhiteRooks;
+        case Piece::WhiteQueen: return WhiteQueens;
+        case Piece::WhiteKing: return WhiteKing;
+        case Piece::BlackPawn: return BlackPawns;
+        case Piece::BlackKnight: return BlackKnights;
+        case Piece::BlackBishop: return BlackBishops;
+        case Piece::BlackRook: return BlackRooks;
+        case Piece::BlackQueen: return BlackQueens;
+        default: return BlackKing;
+        }
+    }
 };
 
-struct ChessPiece {
-    int type;
-    Vector2 position;
-    Vector2 midpoint;
+// What MakeMove overwrites and can't work out again when the move is taken back
+struct UndoRecord {
+    int capturedPiece;
+    GameRuleFlags previousFlags;  // Castling rights, en passant target and halfmove clock
+    uint64_t previousKey;         // Zobrist key before the move
 };
 
 static void iterateAllBitboards(PieceBitboards& bitboards,
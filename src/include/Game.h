@@ -1,28 +1,46 @@
 #pragma once
 #include "CommonComponents.h"
-#include "ChessBoard.h"
 #include "Pieces.h"
+#include "Position.h"
+#include <string>
 #include <vector>
 
 class Game {
 public:
     Game();
 
-    std::vector<Move> GenerateLegalMoves(int currentPiece, int indexOnBoard) const;
-    std::vector<Move> FilterLegalMoves(const std::vector<Move>& moves, int currentPlayer) const;
+    bool LoadFEN(Position& position, const std::string& fen);
+    static std::string SquareName(int square);
+    static int SquareFromName(const std::string& name);
+    static std::string MoveToString(Move move);
+    Move MoveFromString(const Position& position, const std::string& text) const;
+
+    // Fills moves with every legal move of the given type for the side to move without touching the heap
+    void GenerateMoves(const Position& position, MoveList& moves, MoveGenType type = MoveGenType::All) const;
+    // Whether a move that came from somewhere else (the hash table, a killer slot) can be played here
+    bool IsLegal(Position& position, Move move);
+    std::vector<Move> GenerateLegalMoves(const Position& position, int currentPiece, int indexOnBoard) const;
     bool IsPieceWhite(int pieceType) const;
-    bool IsWhiteMove() const;
-    bool IsCorrectMove(int pieceType) const;
-    bool IsSquareAttackedSimple(int square, int attackingColor) const;
-    bool IsKingInCheck(int kingColor) const;
-    bool BlackCheckmate() const;
-    bool WhiteCheckmate() const;
-    bool GameDrawStaleMate() const;
-    bool GameDrawInsufficientMaterial() const;
-    bool GameDrawFiftyMove() const;
-    bool GameDrawThreefold() const;
-    void MakeMove(Move& move, int currentPiece);
+    bool IsWhiteMove(const Position& position) const;
+    bool IsCorrectMove(const Position& position, int pieceType) const;
+    bool IsKingInCheck(const Position& position, int kingColor) const;
+    bool BlackCheckmate(const Position& position) const;
+    bool WhiteCheckmate(const Position& position) const;
+    bool GameDrawStaleMate(const Position& position) const;
+    bool GameDrawInsufficientMaterial(const Position& position) const;
+    bool GameDrawFiftyMove(const Position& position) const;
+    bool GameDrawThreefold(const Position& position) const;
+    // Every end-of-game rule at once, quietly, for callers that already have the legal moves
+    GameResult GetResult(const Position& position, const MoveList& legalMoves) const;
+    void MakeMove(Position& position, Move move);
+    void UnmakeMove(Position& position, Move move);
+    // Passes the turn without moving, for null-move pruning. Never while in check.
+    void MakeNullMove(Position& position);
+    void UnmakeNullMove(Position& position);
 
 private:
+    void PutPiece(Position& position, int piece, int square);
+    void RemovePiece(Position& position, int square);
+
     PieceManager m_pieceManager;
 };
\ No newline at end of file
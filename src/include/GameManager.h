@@ -3,7 +3,6 @@
 #include "ChessBoard.h"
 #include "Game.h"
 #include "Pieces.h"
-#include "ZobristHash.h"
 #include <vector>
 #include <functional>
 
@@ -22,10 +21,13 @@ private:
     void render();
     void cleanup();
     void notifyMoveObservers();
+    // Piece type a pawn dropped on the last rank becomes: hold N, B or R to underpromote, otherwise a queen
+    static int promotionChoice();
 
     ChessBoard m_board;
     Game m_game;
-    ZobristHash m_zobristHash;
+    Position m_position;
+    int m_selectedPieceIndex;
     std::vector<Move> m_currentLegalMoves;
     Vector2 m_dragOffset;
     std::vector<std::function<void()>> m_moveObservers;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CommonComponents.h"
+#include "BitBoard.h"
+#include "BitboardOps.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// Everything the rules need to know about one position. A plain value with no GUI state,
+// so a search thread or a second game can simply take its own copy.
+struct Position {
+    BoardState board;
+    PieceBitboards bitboards;
+    GameRuleFlags gameFlags;
+    int moveCount = 1;     // Odd whenever it's white's turn
+    uint64_t key = 0;      // Zobrist key of the current position, kept up to date by MakeMove/UnmakeMove
+    uint64_t pawnKey = 0;  // Zobrist key of the pawns alone, kept up to date by PutPiece/RemovePiece
+    int kingSquares[2] = { -1, -1 };  // White, black. Kept up to date by PutPiece.
+    // Material plus piece-square score, white minus black, and the game phase (24 with all pieces
+    // on, 0 with only pawns and kings). Kept up to date by PutPiece/RemovePiece.
+    int middlegame = 0;
+    int endgame = 0;
+    int phase = 0;
+    std::vector<uint64_t> positionHistory;  // Key of every position since LoadFEN, the current one last.
+                                            // MakeMove pushes and UnmakeMove pops, so the game and a
+                                            // search line below it share the one stack.
+    std::vector<UndoRecord> undoStack;
+
+    Position() {
+        board.fill(Piece::None);
+
+        // Deep enough for any real game or search line, so MakeMove never reallocates.
+        // Assigning another position into this one keeps the capacity.
+        positionHistory.reserve(1024);
+        undoStack.reserve(1024);
+    }
+
+    // A copied vector only gets room for its elements, so copies start out reserved like a new
+    // position and then take the contents by assignment
+    Position(const Position& other) : Position() { *this = other; }
+    Position& operator=(const Position& other) = default;
+    Position(Position&& other) = default;
+    Position& operator=(Position&& other) = default;
+
+    // How many times the current position has occurred, this time included
+    int repetitionCount() const {
+        return countRepetitions(INT_MAX);
+    }
+
+    // Whether the current position has occurred before. Inside a search one repetition is
+    // treated as a draw, since whatever repeated once can be repeated again.
+    bool isRepetition() const {
+        return countRepetitions(2) >= 2;
+    }
+
+    int kingSquare(int color) const {
+        return kingSquares[color == Piece::White ? 0 : 1];
+    }
+
+    Bitboard colorOccupancy(bool white) const {
+        if (white) {
+            return bitboards.WhitePawns | bitboards.WhiteKnights | bitboards.WhiteBishops |
+                bitboards.WhiteRooks | bitboards.WhiteQueens | bitboards.WhiteKing;
+        }
+        return bitboards.BlackPawns | bitboards.BlackKnights | bitboards.BlackBishops |
+            bitboards.BlackRooks | bitboards.BlackQueens | bitboards.BlackKing;
+    }
+
+    Bitboard occupancy() const {
+        return colorOccupancy(true) | colorOccupancy(false);
+    }
+
+    // Every piece of either colour that attacks the square. Sliders stop at the given occupancy,
+    // so callers can lift pieces off the board first (a moving king, an x-raying slider).
+    Bitboard attackersTo(int square, Bitboard occupancy) const {
+        const PieceBitboards& bb = bitboards;
+        // A white pawn attacks the square from the squares a black pawn standing on it would attack, and vice versa
+        return (BitboardOps::PawnAttacks[1][square] & bb.WhitePawns) |
+            (BitboardOps::PawnAttacks[0][square] & bb.BlackPawns) |
+            (BitboardOps::KnightAttacks[square] & (bb.WhiteKnights | bb.BlackKnights)) |
+            (BitboardOps::KingAttacks[square] & (bb.WhiteKing | bb.BlackKing)) |
+            (BitboardOps::bishopAttacks(square, occupancy) & (bb.WhiteBishops | bb.BlackBishops | bb.WhiteQueens | bb.BlackQueens)) |
+            (BitboardOps::rookAttacks(square, occupancy) & (bb.WhiteRooks | bb.BlackRooks | bb.WhiteQueens | bb.BlackQueens));
+    }
+
+private:
+    // Occurrences of the current position, this time included, counting no further than stopAt.
+    // Only positions since the last capture or pawn move can match, and only every other one has
+    // the same side to move, so the scan is bounded by the halfmove clock and never allocates.
+    int countRepetitions(int stopAt) const {
+        int last = static_cast<int>(positionHistory.size()) - 1;
+        int limit = std::min(gameFlags.halfMoveClock, last);
+        int count = 1;
+        for (int distance = 4; distance <= limit && count < stopAt; distance += 2) {
+            if (positionHistory[last - distance] == key) {
+                count++;
+            }
+        }
+        return count;
+    }
+};
@@ -1,22 +1,67 @@
 #pragma once
 
 #include <array>
-#include <random>
+#include <cstdint>
 #include "CommonComponents.h"
-#include "Pieces.h"
+
+namespace ZobristKeys {
+    const int PIECE_TYPES = 12; // 6 piece types for each color
+    const int SQUARES = 64;
+
+    struct KeyTable {
+        std::array<std::array<uint64_t, SQUARES>, PIECE_TYPES> pieces{};
+        uint64_t blackToMove = 0;
+        std::array<uint64_t, 16> castling{};  // Indexed by GameRuleFlags::castlingRights()
+        std::array<uint64_t, 8> enPassantFile{};
+    };
+
+    // splitmix64. Small, fast and good enough to fill a Zobrist table.
+    constexpr uint64_t nextRandom(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr KeyTable generate(uint64_t seed) {
+        KeyTable table;
+        uint64_t state = seed;
+        for (int i = 0; i < PIECE_TYPES; ++i)
+            for (int j = 0; j < SQUARES; ++j)
+                table.pieces[i][j] = nextRandom(state);
+
+        table.blackToMove = nextRandom(state);
+
+        // One key per right (KQkq); every combination is the XOR of the rights it contains
+        uint64_t rightKeys[4] = {};
+        for (int i = 0; i < 4; ++i)
+            rightKeys[i] = nextRandom(state);
+        for (int rights = 0; rights < 16; ++rights)
+            for (int i = 0; i < 4; ++i)
+                if (rights & (1 << i))
+                    table.castling[rights] ^= rightKeys[i];
+
+        for (int i = 0; i < 8; ++i)
+            table.enPassantFile[i] = nextRandom(state);
+        return table;
+    }
+
+    // Built at compile time from a fixed seed, so a position hashes to the same key in every
+    // run and keys can be stored on disk or compared between processes
+    inline constexpr KeyTable KEYS = generate(0x5EEDC0FFEE1234ULL);
+}
 
 class ZobristHash {
 public:
-    ZobristHash();
-    uint64_t hash(const BoardState& board, bool isBlackToMove, const GameRuleFlags& flags);
-
-private:
-    static const int PIECE_TYPES = 12; // 6 piece types for each color
-    static const int SQUARES = 64;
-    std::array<std::array<uint64_t, SQUARES>, PIECE_TYPES> pieceHashes;
-    uint64_t blackToMove;
-    std::array<uint64_t, 4> castlingRights; // KQkq
-    std::array<uint64_t, 8> enPassantFile;
-
-    void initializeRandomNumbers();
-};
\ No newline at end of file
+    // Full recomputation over all 64 squares. Only needed when a position is set up; MakeMove keeps the key up to date.
+    static uint64_t hash(const BoardState& board, bool isBlackToMove, const GameRuleFlags& flags);
+    // Pawns only, for caching pawn structure. Kept up to date by PutPiece/RemovePiece.
+    static uint64_t pawnHash(const BoardState& board);
+
+    static constexpr uint64_t pieceKey(int piece, int square) {
+        return ZobristKeys::KEYS.pieces[Piece::index(piece)][square];
+    }
+    static constexpr uint64_t castlingKey(int castlingRights) { return ZobristKeys::KEYS.castling[castlingRights]; }
+    static constexpr uint64_t enPassantKey(int square) { return square == -1 ? 0 : ZobristKeys::KEYS.enPassantFile[square % 8]; }
+    static constexpr uint64_t sideKey() { return ZobristKeys::KEYS.blackToMove; }
+};
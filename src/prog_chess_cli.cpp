@@ -0,0 +1,639 @@
+#include "include/Game.h"
+#include "include/BitboardOps.h"
+#include "include/CommonComponents.h"
+#include "../AI/Search/Search.h"
+#include "../AI/Search/ThreadPool.h"
+#include "../AI/MCTS/ChessState.h"
+#include "../AI/MCTS/MCTS.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless front end for the rules engine. No window is opened, so this is what we use to check
+// the move generator and measure its speed.
+//
+//   prog_chess_cli perft <depth> [fen]     total leaf nodes and nodes/sec
+//   prog_chess_cli divide <depth> [fen]    leaf nodes under each root move
+//   prog_chess_cli suite                   reference positions checked against known counts
+//   prog_chess_cli search <depth> [fen]    iterative deepening search, one line per depth
+//   prog_chess_cli speedup [depth]         time to depth on 1 to 16 threads
+//   prog_chess_cli bench [depth]           fixed search of the bench positions; the node total is
+//                                          a signature that changes only when the search does
+//   prog_chess_cli mcts <iterations> [threads] [fen]
+//                                          Monte Carlo tree search with random playouts
+//   prog_chess_cli mctsnet <weights> <iterations> [threads] [fen]
+//                                          MCTS guided by a policy/value network
+//   prog_chess_cli netinit <weights> [seed]
+//                                          write a network of random weights
+//   prog_chess_cli netbench <weights>      network positions/sec at several batch sizes
+//   prog_chess_cli mctsgame <plies> <iterations> [fen]
+//                                          MCTS self-play that keeps its tree between moves
+//   prog_chess_cli mctsspeedup [ms]        MCTS playouts/sec on 1 to 16 threads
+//   prog_chess_cli uci                     play through a UCI GUI or match runner
+
+namespace {
+    const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const int BENCH_DEPTH = 13;
+
+    struct PerftCase {
+        const char* name;
+        const char* fen;
+        int depth;
+        uint64_t nodes;
+    };
+
+    // Published counts from https://www.chessprogramming.org/Perft_Results plus the edge case
+    // collection that circulates on TalkChess. Each one targets a rule that is easy to get wrong.
+    const PerftCase PERFT_SUITE[] = {
+        { "Start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL },
+        { "Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690ULL },
+        { "Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL },
+        { "Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL },
+        { "Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89941194ULL },
+        { "Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551ULL },
+        { "Illegal en passant (pinned on rank)", "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL },
+        { "En passant discovers check", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL },
+        { "Avoid illegal en passant", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133ULL },
+        { "Short castling gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL },
+        { "Long castling gives check", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711ULL },
+        { "Castling rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206ULL },
+        { "Castling prevented", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476ULL },
+        { "Promote out of check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001ULL },
+        { "Discovered check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5, 1004658ULL },
+        { "Promote to give check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342ULL },
+        { "Underpromote to check", "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683ULL },
+        { "Self stalemate", "K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6, 2217ULL },
+        { "Stalemate and checkmate", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL },
+        { "Double check", "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL },
+    };
+
+    // Counts leaves with make/unmake. The last ply just counts the legal moves instead of playing them.
+    uint64_t Perft(Game& game, Position& position, int depth) {
+        MoveList moves;
+        game.GenerateMoves(position, moves);
+        if (depth <= 1) {
+            return depth == 1 ? moves.size() : 1;
+        }
+
+        uint64_t nodes = 0;
+        for (Move move : moves) {
+            game.MakeMove(position, move);
+            nodes += Perft(game, position, depth - 1);
+            game.UnmakeMove(position, move);
+        }
+        return nodes;
+    }
+
+    double SecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void PrintSpeed(uint64_t nodes, double seconds) {
+        std::cout << "Nodes: " << nodes << "\n"
+                  << "Time: " << seconds << " s\n"
+                  << "NPS: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << std::endl;
+    }
+
+    int RunPerft(Game& game, Position& position, int depth, bool divide) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t total = 0;
+
+        if (divide) {
+            MoveList moves;
+            game.GenerateMoves(position, moves);
+            for (Move move : moves) {
+                game.MakeMove(position, move);
+                uint64_t nodes = Perft(game, position, depth - 1);
+                game.UnmakeMove(position, move);
+                std::cout << Game::MoveToString(move) << ": " << nodes << "\n";
+                total += nodes;
+            }
+            std::cout << "\nMoves: " << moves.size() << "\n";
+        }
+        else {
+            total = Perft(game, position, depth);
+        }
+
+        PrintSpeed(total, SecondsSince(start));
+        return 0;
+    }
+
+    int RunSuite(Game& game, Position& position) {
+        int failures = 0;
+        uint64_t totalNodes = 0;
+        auto suiteStart = std::chrono::steady_clock::now();
+
+        for (const PerftCase& test : PERFT_SUITE) {
+            game.LoadFEN(position, test.fen);
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = Perft(game, position, test.depth);
+            double seconds = SecondsSince(start);
+            totalNodes += nodes;
+
+            bool passed = nodes == test.nodes;
+            failures += passed ? 0 : 1;
+            std::cout << (passed ? "[ OK ] " : "[FAIL] ") << test.name << " depth " << test.depth << ": " << nodes;
+            if (!passed) {
+                std::cout << " (expected " << test.nodes << ")";
+            }
+            std::cout << "  " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " nps\n";
+        }
+
+        std::cout << "\n";
+        PrintSpeed(totalNodes, SecondsSince(suiteStart));
+        std::cout << (failures == 0 ? "All positions passed" : std::to_string(failures) + " position(s) failed") << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Everything after the depth is treated as the FEN, so it doesn't need quoting
+    std::string FenFromArgs(int argc, char** argv, int first) {
+        std::string fen;
+        for (int i = first; i < argc; i++) {
+            fen += (fen.empty() ? "" : " ") + std::string(argv[i]);
+        }
+        return fen.empty() ? START_FEN : fen;
+    }
+
+    // Mate scores are reported in moves, as UCI expects
+    std::string ScoreToString(int score) {
+        if (std::abs(score) >= MATE_BOUND) {
+            int plies = MATE_SCORE - std::abs(score);
+            return "mate " + std::to_string(score > 0 ? (plies + 1) / 2 : -(plies / 2));
+        }
+        return "cp " + std::to_string(score);
+    }
+
+    void PrintInfo(const SearchInfo& info) {
+        std::cout << "info depth " << info.depth << " score " << ScoreToString(info.score)
+                  << " nodes " << info.nodes << " time " << info.time
+                  << " nps " << (info.time > 0 ? info.nodes * 1000 / info.time : 0)
+                  << " hashfull " << info.hashfull << " pv";
+        for (Move move : info.pv) {
+            std::cout << " " << Game::MoveToString(move);
+        }
+        std::cout << std::endl;
+    }
+
+    void PrintBestMove(const SearchResult& result) {
+        std::cout << "bestmove " << (result.bestMove.isNone() ? "0000" : Game::MoveToString(result.bestMove)) << std::endl;
+    }
+
+    int RunSearch(const Position& position, int depth) {
+        SearchLimits limits;
+        limits.depth = depth;
+        TranspositionTable tt;
+        ThreadPool threads(tt);
+        PrintBestMove(threads.run(position, limits, PrintInfo));
+        return 0;
+    }
+
+    // Middlegame and endgame positions with enough going on that extra threads have work to share
+    const char* const SEARCH_POSITIONS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+        "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1",
+    };
+
+    // Time to reach a fixed depth on every position, for each thread count. Lazy SMP is judged by
+    // time to depth rather than nodes/sec, since helpers that only repeat work add nodes but no speed.
+    int RunSpeedup(Game& game, Position& position, int depth) {
+        TranspositionTable tt;
+        double baseline = 0;
+
+        for (int threadCount : { 1, 2, 4, 8, 16 }) {
+            ThreadPool threads(tt, threadCount);
+            SearchLimits limits;
+            limits.depth = depth;
+            uint64_t nodes = 0;
+            auto start = std::chrono::steady_clock::now();
+
+            for (const char* fen : SEARCH_POSITIONS) {
+                game.LoadFEN(position, fen);
+                tt.clear();
+                nodes += threads.run(position, limits).nodes;
+            }
+
+            double seconds = SecondsSince(start);
+            baseline = threadCount == 1 ? seconds : baseline;
+            std::cout << "Threads " << threadCount << ": " << seconds << " s, " << nodes << " nodes, "
+                      << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " nps, speedup "
+                      << (seconds > 0 ? baseline / seconds : 0) << "x" << std::endl;
+        }
+        return 0;
+    }
+
+    // One thread with the hash and history cleared before every position, so the node count
+    // depends on nothing but the search itself
+    int RunBench(Game& game, Position& position, int depth) {
+        TranspositionTable tt;
+        ThreadPool threads(tt);
+        SearchLimits limits;
+        limits.depth = depth;
+        uint64_t total = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const char* fen : SEARCH_POSITIONS) {
+            game.LoadFEN(position, fen);
+            tt.clear();
+            threads.clear();
+            SearchResult result = threads.run(position, limits);
+            std::cout << fen << ": " << result.nodes << " nodes, bestmove " << Game::MoveToString(result.bestMove) << "\n";
+            total += result.nodes;
+        }
+
+        std::cout << "\n";
+        PrintSpeed(total, SecondsSince(start));
+        return 0;
+    }
+
+    int RunMcts(Game& game, const Position& position, int iterations, int threadCount, const Network* network = nullptr) {
+        ChessState state(game, position);
+        MCTS mcts(std::sqrt(2), 1 << 20, threadCount);
+        mcts.setNetwork(network);
+        MctsLimits limits;
+        limits.iterations = iterations;
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result;
+        result.bestMove = mcts.search(state, limits);
+        double seconds = SecondsSince(start);
+
+        std::cout << "Iterations: " << mcts.iterationCount() << "\n"
+                  << "Tree nodes: " << mcts.nodeCount() << "\n"
+                  << "Time: " << seconds << " s\n"
+                  << "Iterations/sec: " << static_cast<uint64_t>(seconds > 0 ? mcts.iterationCount() / seconds : 0) << "\n";
+        PrintBestMove(result);
+        return 0;
+    }
+
+    int RunNetworkInit(const std::string& path, uint32_t seed) {
+        Network network;
+        network.randomize(seed);
+        if (!network.save(path)) {
+            std::cerr << "Couldn't write " << path << std::endl;
+            return 1;
+        }
+        std::cout << "Random weights written to " << path << std::endl;
+        return 0;
+    }
+
+    // Positions/sec through the network at several batch sizes, on the search positions
+    int RunNetworkBench(Game& game, Position& position, const Network& network) {
+        const int POSITIONS = 20000;
+        std::vector<NetworkInput> inputs;
+        for (const char* fen : SEARCH_POSITIONS) {
+            game.LoadFEN(position, fen);
+            MoveList moves;
+            game.GenerateMoves(position, moves);
+            inputs.emplace_back();
+            Network::encode(position, moves, inputs.back());
+        }
+
+        std::cout << "Kernels: " << Network::kernelName() << std::endl;
+        for (int batchSize : { 1, 4, 16, 64 }) {
+            NetworkBatch batch(batchSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int done = 0; done < POSITIONS; done += batchSize) {
+                for (batch.count = 0; !batch.full();) {
+                    batch.add() = inputs[(done + batch.count) % inputs.size()];
+                }
+                network.evaluate(batch);
+            }
+            double seconds = SecondsSince(start);
+            std::cout << "Batch " << batchSize << ": "
+                      << static_cast<uint64_t>(seconds > 0 ? POSITIONS / seconds : 0) << " positions/s" << std::endl;
+        }
+        return 0;
+    }
+
+    // The search plays both sides and keeps one tree for the whole game, so each search starts
+    // from the subtree the previous one had already built under the move that was played
+    int RunMctsGame(Game& game, Position& position, int plies, int iterations) {
+        MCTS mcts;
+        MctsLimits limits;
+        limits.iterations = iterations;
+        uint64_t reusedTotal = 0;
+        uint64_t playoutTotal = 0;
+
+        for (int ply = 1; ply <= plies; ++ply) {
+            ChessState state(game, position);
+            if (state.isTerminal()) {
+                break;
+            }
+            Move best = mcts.search(state, limits);
+            reusedTotal += mcts.reusedVisits();
+            playoutTotal += mcts.iterationCount();
+            std::cout << ply << ". " << Game::MoveToString(best) << "  reused " << mcts.reusedVisits()
+                      << " visits, tree " << mcts.nodeCount() << " nodes" << std::endl;
+
+            game.MakeMove(position, best);
+            mcts.advance(best, ChessState(game, position));
+        }
+
+        uint64_t visits = reusedTotal + playoutTotal;
+        std::cout << "Reused visits: " << reusedTotal << " of " << visits << " ("
+                  << (visits > 0 ? 100.0 * reusedTotal / visits : 0) << "%)" << std::endl;
+        return 0;
+    }
+
+    // Playouts per second over a fixed time on each thread count. Tree parallelism is judged by
+    // throughput here; the virtual loss keeps the extra threads from piling onto one line.
+    int RunMctsSpeedup(Game& game, Position& position, int64_t moveTime) {
+        double baseline = 0;
+        for (int threadCount : { 1, 2, 4, 8, 16 }) {
+            MCTS mcts(std::sqrt(2), 1 << 22, threadCount);
+            MctsLimits limits;
+            limits.moveTime = moveTime;
+            uint64_t playouts = 0;
+            auto start = std::chrono::steady_clock::now();
+
+            for (const char* fen : SEARCH_POSITIONS) {
+                game.LoadFEN(position, fen);
+                ChessState state(game, position);
+                mcts.clearTree();
+                mcts.search(state, limits);
+                playouts += mcts.iterationCount();
+            }
+
+            double seconds = SecondsSince(start);
+            double rate = seconds > 0 ? playouts / seconds : 0;
+            baseline = threadCount == 1 ? rate : baseline;
+            std::cout << "Threads " << threadCount << ": " << playouts << " playouts, "
+                      << static_cast<uint64_t>(rate) << " playouts/s, scaling "
+                      << (baseline > 0 ? rate / baseline : 0) << "x" << std::endl;
+        }
+        return 0;
+    }
+
+    // position [startpos | fen <fen>] [moves <move>...]. A FEN that doesn't load leaves the
+    // previous position as it was, moves and all.
+    void SetPosition(Game& game, Position& position, std::istringstream& tokens) {
+        std::string token, fen;
+        tokens >> token;
+        if (token == "startpos") {
+            fen = START_FEN;
+            tokens >> token;
+        }
+        else if (token == "fen") {
+            while (tokens >> token && token != "moves") {
+                fen += (fen.empty() ? "" : " ") + token;
+            }
+        }
+        else {
+            return;
+        }
+
+        Position loaded;
+        if (!game.LoadFEN(loaded, fen)) {
+            return;
+        }
+        position = loaded;
+        if (token == "moves") {
+            while (tokens >> token) {
+                Move move = game.MoveFromString(position, token);
+                if (move.isNone()) {
+                    break;
+                }
+                game.MakeMove(position, move);
+            }
+        }
+    }
+
+    // go [depth n] [nodes n] [movetime ms] [wtime ms btime ms winc ms binc ms movestogo n] [infinite]
+    SearchLimits ParseGo(std::istringstream& tokens, bool whiteToMove) {
+        SearchLimits limits;
+        std::string token;
+        while (tokens >> token) {
+            if (token == "depth") tokens >> limits.depth;
+            else if (token == "nodes") tokens >> limits.nodes;
+            else if (token == "movetime") tokens >> limits.moveTime;
+            else if (token == (whiteToMove ? "wtime" : "btime")) tokens >> limits.timeLeft;
+            else if (token == (whiteToMove ? "winc" : "binc")) tokens >> limits.increment;
+            else if (token == "movestogo") tokens >> limits.movesToGo;
+            else if (token == "infinite") limits.infinite = true;
+        }
+        return limits;
+    }
+
+    // The search runs on its own thread so "stop" and "isready" are still answered while it thinks
+    int RunUci(Game& game, Position& position) {
+        TranspositionTable tt;
+        ThreadPool threads(tt);
+        std::thread searchThread;
+        auto waitForSearch = [&]() {
+            if (searchThread.joinable()) {
+                searchThread.join();
+            }
+        };
+        auto stopSearch = [&]() {
+            threads.stop();
+            waitForSearch();
+        };
+
+        game.LoadFEN(position, START_FEN);
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            std::istringstream tokens(line);
+            std::string command;
+            tokens >> command;
+
+            if (command == "uci") {
+                std::cout << "id name prog_chess_engine\n"
+                          << "id author kamdynshaeffer\n"
+                          << "option name Hash type spin default 16 min 1 max 65536\n"
+                          << "option name Threads type spin default 1 min 1 max 256\n";
+                const SearchParameters defaults;
+                for (const TunableParameter& parameter : TunableParameters()) {
+                    std::cout << "option name " << parameter.name << " type spin default " << defaults.*parameter.field
+                              << " min " << parameter.min << " max " << parameter.max << "\n";
+                }
+                std::cout << "uciok" << std::endl;
+            }
+            else if (command == "setoption") {
+                stopSearch();
+                std::string token, name, value;
+                tokens >> token >> name >> token >> value;  // setoption name <name> value <value>
+                if (name == "Hash") {
+                    tt.resize(std::max(1, std::atoi(value.c_str())));
+                }
+                else if (name == "Threads") {
+                    threads.setThreadCount(std::max(1, std::atoi(value.c_str())));
+                }
+                else {
+                    SearchParameters parameters = threads.searchParameters();
+                    for (const TunableParameter& parameter : TunableParameters()) {
+                        if (name == parameter.name) {
+                            parameters.*parameter.field = std::max(parameter.min, std::min(parameter.max, std::atoi(value.c_str())));
+                        }
+                    }
+                    threads.setParameters(parameters);
+                }
+            }
+            else if (command == "isready") {
+                std::cout << "readyok" << std::endl;
+            }
+            else if (command == "ucinewgame") {
+                stopSearch();
+                tt.clear();
+                threads.clear();
+                game.LoadFEN(position, START_FEN);
+            }
+            else if (command == "position") {
+                stopSearch();
+                SetPosition(game, position, tokens);
+            }
+            else if (command == "go") {
+                stopSearch();
+                threads.prepare(position, ParseGo(tokens, game.IsWhiteMove(position)));
+                searchThread = std::thread([&threads]() { PrintBestMove(threads.think(PrintInfo)); });
+            }
+            else if (command == "stop") {
+                stopSearch();
+            }
+            else if (command == "quit") {
+                break;
+            }
+        }
+
+        stopSearch();
+        return 0;
+    }
+
+    int PrintUsage() {
+        std::cerr << "usage: prog_chess_cli perft <depth> [fen]\n"
+                  << "       prog_chess_cli divide <depth> [fen]\n"
+                  << "       prog_chess_cli suite\n"
+                  << "       prog_chess_cli search <depth> [fen]\n"
+                  << "       prog_chess_cli speedup [depth]\n"
+                  << "       prog_chess_cli bench [depth]\n"
+                  << "       prog_chess_cli mcts <iterations> [threads] [fen]\n"
+                  << "       prog_chess_cli mctsnet <weights> <iterations> [threads] [fen]\n"
+                  << "       prog_chess_cli netinit <weights> [seed]\n"
+                  << "       prog_chess_cli netbench <weights>\n"
+                  << "       prog_chess_cli mctsgame <plies> <iterations> [fen]\n"
+                  << "       prog_chess_cli mctsspeedup [ms]\n"
+                  << "       prog_chess_cli uci" << std::endl;
+        return 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    BitboardOps::initSlidingAttacks();
+    Game game;
+    Position position;
+
+    if (argc < 2) {
+        return PrintUsage();
+    }
+    std::string command = argv[1];
+
+    if (command == "suite") {
+        return RunSuite(game, position);
+    }
+
+    if (command == "uci") {
+        return RunUci(game, position);
+    }
+
+    if (command == "search" && argc >= 3) {
+        int depth = std::atoi(argv[2]);
+        if (depth < 1 || !game.LoadFEN(position, FenFromArgs(argc, argv, 3))) {
+            return PrintUsage();
+        }
+        return RunSearch(position, depth);
+    }
+
+    if (command == "speedup") {
+        int depth = argc >= 3 ? std::atoi(argv[2]) : 6;
+        if (depth < 1) {
+            return PrintUsage();
+        }
+        return RunSpeedup(game, position, depth);
+    }
+
+    if (command == "mcts" && argc >= 3) {
+        int iterations = std::atoi(argv[2]);
+        // The thread count is optional, and a FEN never starts with a plain number
+        bool hasThreads = argc >= 4 && std::string(argv[3]).find_first_not_of("0123456789") == std::string::npos;
+        int threadCount = hasThreads ? std::atoi(argv[3]) : 1;
+        if (iterations < 1 || threadCount < 1 || !game.LoadFEN(position, FenFromArgs(argc, argv, hasThreads ? 4 : 3))) {
+            return PrintUsage();
+        }
+        return RunMcts(game, position, iterations, threadCount);
+    }
+
+    if (command == "mctsnet" && argc >= 4) {
+        Network network;
+        if (!network.load(argv[2])) {
+            std::cerr << "Couldn't load weights from " << argv[2] << std::endl;
+            return 1;
+        }
+        int iterations = std::atoi(argv[3]);
+        bool hasThreads = argc >= 5 && std::string(argv[4]).find_first_not_of("0123456789") == std::string::npos;
+        int threadCount = hasThreads ? std::atoi(argv[4]) : 1;
+        if (iterations < 1 || threadCount < 1 || !game.LoadFEN(position, FenFromArgs(argc, argv, hasThreads ? 5 : 4))) {
+            return PrintUsage();
+        }
+        return RunMcts(game, position, iterations, threadCount, &network);
+    }
+
+    if (command == "netinit" && argc >= 3) {
+        uint32_t seed = argc >= 4 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+        return RunNetworkInit(argv[2], seed);
+    }
+
+    if (command == "netbench" && argc >= 3) {
+        Network network;
+        if (!network.load(argv[2])) {
+            std::cerr << "Couldn't load weights from " << argv[2] << std::endl;
+            return 1;
+        }
+        return RunNetworkBench(game, position, network);
+    }
+
+    if (command == "mctsgame" && argc >= 4) {
+        int plies = std::atoi(argv[2]);
+        int iterations = std::atoi(argv[3]);
+        if (plies < 1 || iterations < 1 || !game.LoadFEN(position, FenFromArgs(argc, argv, 4))) {
+            return PrintUsage();
+        }
+        return RunMctsGame(game, position, plies, iterations);
+    }
+
+    if (command == "mctsspeedup") {
+        int64_t moveTime = argc >= 3 ? std::atoll(argv[2]) : 1000;
+        if (moveTime < 1) {
+            return PrintUsage();
+        }
+        return RunMctsSpeedup(game, position, moveTime);
+    }
+
+    if (command == "bench") {
+        int depth = argc >= 3 ? std::atoi(argv[2]) : BENCH_DEPTH;
+        if (depth < 1) {
+            return PrintUsage();
+        }
+        return RunBench(game, position, depth);
+    }
+
+    if ((command == "perft" || command == "divide") && argc >= 3) {
+        int depth = std::atoi(argv[2]);
+        if (depth < 1 || !game.LoadFEN(position, FenFromArgs(argc, argv, 3))) {
+            return PrintUsage();
+        }
+        return RunPerft(game, position, depth, command == "divide");
+    }
+
+    return PrintUsage();
+}
@@ -1,6 +1,8 @@
 #include "include/GameManager.h"
+#include "include/BitboardOps.h"
 
 int main(void) {
+    BitboardOps::initSlidingAttacks();
     GameManager gameManager;
     gameManager.run();
     return 0;